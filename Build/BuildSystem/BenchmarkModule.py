@@ -0,0 +1,30 @@
+# Copyright 2025, LiserverYang. All rights reserved.
+
+from .BuildContext import BuildContext
+from .BuildTypeEnum import BuildTypeEnum
+from .Logger import Logger
+from .LogLevelEnum import LogLevelEnum
+from typing import List
+
+import os
+
+def BenchmarkModule(ModuleName:str, ModulePath: str, ModuleOFiles: List[str], ArgumentsAdded: str):
+    """
+    This function can build and run the benchmarks of a module (all benchmark files should be at ModulePath/Benchmarks/*).
+    The benchmark files provide their own main function.
+    """
+    
+    Logger.Log(LogLevelEnum.Info, f"Benchmarking module '{ModuleName}'")
+
+    if BuildContext.BuildType != BuildTypeEnum.Release:
+        Logger.Log(LogLevelEnum.Warning, f"Benchmarks of module '{ModuleName}' are not built in Release mode, the results are not meaningful")
+
+    BenchmarkPath: str = ModulePath + "/Benchmarks/"
+
+    BuildResult = os.system(f"g++ {BenchmarkPath}*.cpp {' '.join(ModuleOFiles)} -o ./Build/Intermediate/benchmark {ArgumentsAdded} -I{ModulePath}/Public/")
+    
+    if BuildResult != 0:
+        Logger.Log(LogLevelEnum.Error, f"Unable to build benchmark file for module '{ModuleName}' and the compiler return {BuildResult}", True, -1)
+
+    if os.system("powershell ./Build/Intermediate/benchmark") != 0:
+        Logger.Log(LogLevelEnum.Error, f"Benchmark module '{ModuleName}' faild. See log to find out what happend.", True, -1)
\ No newline at end of file
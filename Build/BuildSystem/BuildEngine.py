@@ -35,6 +35,7 @@ def BuildEngine(SourceFolder: FileIO, TargetList: List[str]) -> None:
     parser.add_argument('--donot-build-files', help='If enabled, the build system will not execute the compile/link command, but something like format check will be executed', action="store_true")
     parser.add_argument('--donot-use-o-files', help='If enabled, the build system will not use cache (.o files) to build module', action="store_true")
     parser.add_argument('--enable-tests', help='If enabled, the build system will execute the unit test with google test (all test file should be at ModuolePath/Test/**)', action="store_true")
+    parser.add_argument('--enable-benchmarks', help='If enabled, the build system will build and run the benchmarks (all benchmark files should be at ModuolePath/Benchmarks/**)', action="store_true")
     parser.add_argument('--enable-format-check', help='If enabled, the build system will check the code format with clang-format', action="store_true")
     parser.add_argument('--llvm-position', help='If enabled, the build system set the llvm position', default="")
     BuildContext.Arguments = parser.parse_args()
@@ -9,6 +9,7 @@ from .BinaryTypeEnum import BinaryTypeEnum
 from .Functions import GetCurrentSystem
 from .SystemEnum import SystemEnum
 from .TestModule import TestModule
+from .BenchmarkModule import BenchmarkModule
 from .FormatCheck import CheckFormat
 
 from typing import List
@@ -203,4 +204,8 @@ def BuildModule(ModuleName: str):
 
         # Run test
     if BuildContext.Arguments.enable_tests and BuildContext.ModuleConfiguration[ModuleID].EnableTests:
-        TestModule(ModuleName, os.path.dirname(BuildContext.ModulePath[ModuleID]), CxxOFilesList, f"{ModuleAddedArguments} {TargetAddedArguments} -I{IncludePaths} -L ./Build/Binaries/ {LinkDependsStr} -l{LibPrefix}{ModuleName}")
\ No newline at end of file
+        TestModule(ModuleName, os.path.dirname(BuildContext.ModulePath[ModuleID]), CxxOFilesList, f"{ModuleAddedArguments} {TargetAddedArguments} -I{IncludePaths} -L ./Build/Binaries/ {LinkDependsStr} -l{LibPrefix}{ModuleName}")
+
+    # Run benchmarks
+    if BuildContext.Arguments.enable_benchmarks and BuildContext.ModuleConfiguration[ModuleID].EnableBenchmarks:
+        BenchmarkModule(ModuleName, os.path.dirname(BuildContext.ModulePath[ModuleID]), CxxOFilesList, f"{ModuleAddedArguments} {TargetAddedArguments} -I{IncludePaths} -L ./Build/Binaries/ {LinkDependsStr} -l{LibPrefix}{ModuleName}")
\ No newline at end of file
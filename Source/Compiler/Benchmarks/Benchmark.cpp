@@ -0,0 +1,155 @@
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string_view>
+#include <vector>
+
+// 统计全局的内存分配次数
+static std::atomic<size_t> allocationCount{0};
+
+void *operator new(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (void *pointer = std::malloc(size ? size : 1))
+    {
+        return pointer;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void BenchmarkState::start()
+{
+    allocations = allocationCount.load(std::memory_order_relaxed);
+    startTime = std::chrono::steady_clock::now();
+}
+
+void BenchmarkState::stop()
+{
+    stopTime = std::chrono::steady_clock::now();
+    allocations = allocationCount.load(std::memory_order_relaxed) - allocations;
+}
+
+struct BenchmarkCase
+{
+    const char *name;
+    BenchmarkFunction function;
+};
+
+static std::vector<BenchmarkCase> &getBenchmarks()
+{
+    static std::vector<BenchmarkCase> benchmarks;
+    return benchmarks;
+}
+
+bool registerBenchmark(const char *name, BenchmarkFunction function)
+{
+    getBenchmarks().push_back({name, function});
+    return true;
+}
+
+static BenchmarkOptions parseOptions(int argc, const char **argv)
+{
+    BenchmarkOptions options;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view argument = argv[i];
+
+        if (argument.starts_with("--size="))
+        {
+            options.corpusSize = std::strtoull(argv[i] + 7, nullptr, 10) * 1024 * 1024;
+        }
+        else if (argument.starts_with("--iterations="))
+        {
+            options.iterations = std::strtoull(argv[i] + 13, nullptr, 10);
+        }
+        else if (argument.starts_with("--filter="))
+        {
+            options.filter = argument.substr(9);
+        }
+        else
+        {
+            std::fprintf(stderr, "unknown argument '%s'\n", argv[i]);
+            std::exit(1);
+        }
+    }
+
+    if (options.iterations == 0)
+    {
+        options.iterations = 1;
+    }
+
+    return options;
+}
+
+static void printResult(const std::string &name, const BenchmarkState &state)
+{
+    const double seconds = state.getSeconds();
+
+    std::printf("%-32s %10.2f %12.1f %14.0f %14.4f\n",
+                name.c_str(),
+                seconds * 1000,
+                state.bytes / seconds / 1e6,
+                state.items / seconds,
+                state.items ? (double)state.getAllocations() / state.items : 0.0);
+}
+
+int main(int argc, const char **argv)
+{
+    const BenchmarkOptions options = parseOptions(argc, argv);
+
+    std::printf("corpus size: %zu MiB, iterations: %zu\n\n", options.corpusSize / 1024 / 1024, options.iterations);
+    std::printf("%-32s %10s %12s %14s %14s\n", "benchmark", "time(ms)", "MB/s", "tokens/s", "allocs/token");
+
+    for (const BenchmarkCase &benchmark : getBenchmarks())
+    {
+        if (std::string_view(benchmark.name).find(options.filter) == std::string_view::npos)
+        {
+            continue;
+        }
+
+        // 第一次运行时全局的 StringInterner 里还没有语料中的名字，驻留的开销和内存分配只会出现在这一次
+        BenchmarkState cold(options);
+        benchmark.function(cold);
+        printResult(std::string(benchmark.name) + "/cold", cold);
+
+        if (options.iterations == 1)
+        {
+            continue;
+        }
+
+        // 之后的运行取最快的一次，减少其它进程的干扰
+        std::vector<BenchmarkState> warm;
+        warm.reserve(options.iterations - 1);
+
+        for (size_t i = 1; i < options.iterations; i++)
+        {
+            warm.emplace_back(options);
+            benchmark.function(warm.back());
+        }
+
+        const BenchmarkState &best = *std::min_element(warm.begin(), warm.end(), [](const BenchmarkState &a, const BenchmarkState &b) {
+            return a.getSeconds() < b.getSeconds();
+        });
+
+        printResult(std::string(benchmark.name) + "/warm", best);
+    }
+
+    return 0;
+}
\ No newline at end of file
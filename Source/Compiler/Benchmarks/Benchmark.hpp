@@ -0,0 +1,77 @@
+/**
+ * Copyright 2025, LiserverYang. All rights reserved.
+ * 此文件定义了一个简单的基准测试框架
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+/**
+ * 基准测试的命令行选项
+ *     --size=<MiB>        生成的语料大小
+ *     --iterations=<N>    每个基准测试运行的次数，第一次单独报告，之后的取最快的一次
+ *     --filter=<text>     只运行名字中包含 text 的基准测试
+ */
+struct BenchmarkOptions
+{
+    size_t corpusSize = 8 * 1024 * 1024;
+    size_t iterations = 5;
+    std::string filter;
+};
+
+/**
+ * BenchmarkState 记录一次运行的结果
+ * 基准函数只把被测的代码放在 start 和 stop 之间，准备数据的时间和内存分配不会被统计
+ */
+class BenchmarkState
+{
+public:
+    explicit BenchmarkState(const BenchmarkOptions &options) : options(options) {}
+
+    const BenchmarkOptions &options;
+
+    // 被测代码处理的字节数和 Token 数量，由基准函数填写
+    size_t bytes = 0;
+    size_t items = 0;
+
+    void start();
+    void stop();
+
+    inline double getSeconds() const
+    {
+        return std::chrono::duration<double>(stopTime - startTime).count();
+    }
+
+    inline size_t getAllocations() const
+    {
+        return allocations;
+    }
+
+private:
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point stopTime;
+
+    size_t allocations = 0;
+};
+
+using BenchmarkFunction = void (*)(BenchmarkState &state);
+
+// 注册一个基准测试，返回值只用于在静态初始化时调用
+bool registerBenchmark(const char *name, BenchmarkFunction function);
+
+/**
+ * 定义并注册一个基准测试，用法和 gtest 的 TEST 类似：
+ *     BENCHMARK(LexSomething)
+ *     {
+ *         state.start();
+ *         ...
+ *         state.stop();
+ *     }
+ */
+#define BENCHMARK(name)                                                   \
+    static void name(BenchmarkState &state);                              \
+    static const bool name##Registered = registerBenchmark(#name, name); \
+    static void name(BenchmarkState &state)
\ No newline at end of file
@@ -0,0 +1,187 @@
+/**
+ * Copyright 2025, LiserverYang. All rights reserved.
+ * 此文件定义了生成基准测试语料的函数
+ */
+
+#pragma once
+
+#include <random>
+#include <string>
+
+/**
+ * 语料中 Token 的组成
+ */
+enum class CorpusKind
+{
+    IDENTIFIER_HEAVY, // 大部分是标识符和关键字
+    COMMENT_HEAVY,    // 大部分是行注释和块注释
+    LITERAL_HEAVY,    // 大部分是数字、字符串和字符字面量
+    MIXED             // 以上三种的混合，接近真实的代码
+};
+
+/**
+ * CorpusGenerator 生成语法上接近真实代码的 .lis 源代码
+ * 相同的种子总是生成相同的语料，方便对比不同版本的结果
+ */
+class CorpusGenerator
+{
+public:
+    explicit CorpusGenerator(unsigned seed = 1) : random(seed) {}
+
+    // 生成至少 size 字节的语料
+    std::string generate(CorpusKind kind, size_t size)
+    {
+        std::string corpus;
+        corpus.reserve(size + 256);
+
+        while (corpus.size() < size)
+        {
+            CorpusKind lineKind = kind;
+
+            if (kind == CorpusKind::MIXED)
+            {
+                // 真实代码中标识符最多，其次是字面量和注释
+                const unsigned roll = random() % 10;
+                lineKind = roll < 6 ? CorpusKind::IDENTIFIER_HEAVY : roll < 8 ? CorpusKind::LITERAL_HEAVY : CorpusKind::COMMENT_HEAVY;
+            }
+
+            switch (lineKind)
+            {
+            case CorpusKind::IDENTIFIER_HEAVY: appendIdentifierLine(corpus); break;
+            case CorpusKind::COMMENT_HEAVY:
+                // 注释之间偶尔夹杂一行代码
+                appendCommentLine(corpus);
+                if (random() % 4 == 0)
+                {
+                    appendIdentifierLine(corpus);
+                }
+                break;
+            case CorpusKind::LITERAL_HEAVY: appendLiteralLine(corpus); break;
+            default: break;
+            }
+        }
+
+        return corpus;
+    }
+
+private:
+    std::mt19937 random;
+
+    size_t range(size_t low, size_t high)
+    {
+        return low + random() % (high - low + 1);
+    }
+
+    void appendIdentifier(std::string &corpus)
+    {
+        static constexpr const char *words[] = {"point", "value", "index", "count", "buffer", "node", "left", "right", "self", "result", "x", "y"};
+
+        corpus += words[random() % std::size(words)];
+
+        if (random() % 2)
+        {
+            corpus += '_';
+            corpus += words[random() % std::size(words)];
+        }
+
+        if (random() % 3 == 0)
+        {
+            corpus += std::to_string(range(0, 99));
+        }
+    }
+
+    void appendIndent(std::string &corpus)
+    {
+        corpus.append(range(0, 3) * 4, ' ');
+    }
+
+    // 例如 let mut value_x: i32 = left.count + node_index * y;
+    void appendIdentifierLine(std::string &corpus)
+    {
+        static constexpr const char *types[] = {"i32", "i64", "f64", "bool", "char", "Point2D"};
+        static constexpr const char *operators[] = {" + ", " - ", " * ", " / ", " == ", " && ", " || ", "."};
+
+        appendIndent(corpus);
+        corpus += random() % 2 ? "let mut " : "let ";
+        appendIdentifier(corpus);
+        corpus += ": ";
+        corpus += types[random() % std::size(types)];
+        corpus += " = ";
+
+        const size_t terms = range(1, 6);
+        for (size_t i = 0; i < terms; i++)
+        {
+            if (i != 0)
+            {
+                corpus += operators[random() % std::size(operators)];
+            }
+
+            appendIdentifier(corpus);
+        }
+
+        corpus += ";\n";
+    }
+
+    void appendCommentLine(std::string &corpus)
+    {
+        appendIndent(corpus);
+
+        if (random() % 3 == 0)
+        {
+            corpus += "/*";
+            const size_t lines = range(1, 4);
+            for (size_t i = 0; i < lines; i++)
+            {
+                corpus += " * ";
+                corpus.append(range(20, 70), (char)('a' + random() % 26));
+                corpus += '\n';
+            }
+            corpus += " */\n";
+        }
+        else
+        {
+            corpus += "// ";
+            corpus.append(range(10, 80), (char)('a' + random() % 26));
+            corpus += '\n';
+        }
+    }
+
+    // 例如 ret call(12, 3.5e-2, "text\n", 'c');
+    void appendLiteralLine(std::string &corpus)
+    {
+        appendIndent(corpus);
+        corpus += "ret call(";
+
+        const size_t arguments = range(1, 5);
+        for (size_t i = 0; i < arguments; i++)
+        {
+            if (i != 0)
+            {
+                corpus += ", ";
+            }
+
+            switch (random() % 5)
+            {
+            case 0: corpus += std::to_string(random() % 100000); break;
+            case 1: corpus += std::to_string(range(0, 999)) + "." + std::to_string(range(0, 999)) + "e-" + std::to_string(range(1, 9)); break;
+            case 2:
+                corpus += '"';
+                corpus.append(range(4, 40), (char)('a' + random() % 26));
+                corpus += '"';
+                break;
+            case 3:
+                corpus += '"';
+                corpus.append(range(4, 20), (char)('a' + random() % 26));
+                corpus += "\\n\\\"";
+                corpus.append(range(4, 20), (char)('a' + random() % 26));
+                corpus += '"';
+                break;
+            default:
+                corpus += random() % 4 ? "'x'" : "'\\n'";
+                break;
+            }
+        }
+
+        corpus += ");\n";
+    }
+};
\ No newline at end of file
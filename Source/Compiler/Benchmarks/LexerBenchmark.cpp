@@ -0,0 +1,88 @@
+#include "Benchmark.hpp"
+#include "CorpusGenerator.hpp"
+#include "Lexer/Lexer.hpp"
+
+#include <map>
+#include <memory>
+#include <thread>
+
+// 同一种语料只生成一次
+static const std::string &getCorpus(CorpusKind kind, size_t size)
+{
+    static std::map<std::pair<CorpusKind, size_t>, std::string> corpora;
+
+    auto it = corpora.find({kind, size});
+    if (it == corpora.end())
+    {
+        it = corpora.emplace(std::make_pair(kind, size), CorpusGenerator().generate(kind, size)).first;
+    }
+
+    return it->second;
+}
+
+// 测量 Lexer::run 生成完整 TokenStream 的速度
+static void benchmarkLexer(BenchmarkState &state, CorpusKind kind, size_t threadCount)
+{
+    const std::string &corpus = getCorpus(kind, state.options.corpusSize);
+
+    std::shared_ptr<Context> context = std::make_shared<Context>();
+    context->setSource(corpus);
+    context->options.lexerThreads = threadCount;
+
+    Lexer lexer(context);
+
+    state.start();
+    lexer.run();
+    state.stop();
+
+    state.bytes = corpus.size();
+    state.items = context->tokenStream.size();
+}
+
+BENCHMARK(LexIdentifierHeavy)
+{
+    benchmarkLexer(state, CorpusKind::IDENTIFIER_HEAVY, 1);
+}
+
+BENCHMARK(LexCommentHeavy)
+{
+    benchmarkLexer(state, CorpusKind::COMMENT_HEAVY, 1);
+}
+
+BENCHMARK(LexLiteralHeavy)
+{
+    benchmarkLexer(state, CorpusKind::LITERAL_HEAVY, 1);
+}
+
+BENCHMARK(LexMixed)
+{
+    benchmarkLexer(state, CorpusKind::MIXED, 1);
+}
+
+BENCHMARK(LexMixedParallel)
+{
+    benchmarkLexer(state, CorpusKind::MIXED, std::max(1u, std::thread::hardware_concurrency()));
+}
+
+// 流式模式下逐个拉取 Token ，不保存 TokenStream
+BENCHMARK(LexMixedStreaming)
+{
+    const std::string &corpus = getCorpus(CorpusKind::MIXED, state.options.corpusSize);
+
+    std::shared_ptr<Context> context = std::make_shared<Context>();
+    context->setSource(corpus);
+
+    Lexer lexer(context);
+    Token token;
+    size_t count = 0;
+
+    state.start();
+    while (lexer.lexNext(token))
+    {
+        count++;
+    }
+    state.stop();
+
+    state.bytes = corpus.size();
+    state.items = count;
+}
\ No newline at end of file
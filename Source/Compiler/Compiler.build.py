@@ -13,4 +13,5 @@ class CompilerModule(BuildSystem.ModuleBase):
         self.BinaryType = BuildSystem.BinaryTypeEnum.StaticLib
         self.ModulesDependOn = ["Gtest"]
         self.EnableBinaryLibPrefix = False
-        self.EnableTests = True
\ No newline at end of file
+        self.EnableTests = True
+        self.EnableBenchmarks = True
\ No newline at end of file
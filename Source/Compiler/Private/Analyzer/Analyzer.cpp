@@ -0,0 +1,1035 @@
+#include "Analyzer/Analyzer.hpp"
+
+#include "Core/ThreadPool.hpp"
+
+#include <algorithm>
+
+void Analyzer::run()
+{
+    const Program &program = context->program;
+    types = &context->typeContext;
+    currentReturnType = types->getErrorType();
+
+    declareGlobals(program);
+
+    std::vector<FunctionBody> bodies;
+    collectFunctionBodies(program, bodies);
+
+    if (context->options.analyzerThreads > 1)
+    {
+        checkFunctionsInParallel(bodies, context->options.analyzerThreads);
+        return;
+    }
+
+    for (const FunctionBody &function : bodies)
+    {
+        checkFunction(function);
+    }
+}
+
+void Analyzer::error(const ASTNode &node, std::string msg, size_t length)
+{
+    if (diagnosticBuffer != nullptr)
+    {
+        diagnosticBuffer->push_back({Logger::LogLevel::ERROR, std::move(msg), node.offset, length});
+        return;
+    }
+
+    context->report(Logger::LogLevel::ERROR, std::move(msg), node.offset, length);
+}
+
+const Analyzer::Method *Analyzer::findMethod(NameId structName, NameId methodName) const
+{
+    auto it = declarations->methods.find(getMethodKey(structName, methodName));
+    return it == declarations->methods.end() ? nullptr : &it->second;
+}
+
+const SymbolTable::Symbol *Analyzer::lookup(NameId name) const
+{
+    const SymbolTable::Symbol *symbol = localScopes.lookup(name);
+    return symbol != nullptr ? symbol : declarations->globalScope.lookup(name);
+}
+
+/* 声明 */
+
+void Analyzer::declareGlobals(const Program &program)
+{
+    // 结构体最先收集，函数签名和成员类型都可能用到之后定义的结构体
+    for (const ASTNode *node : program.globalStatements)
+    {
+        if (auto structDef = dyn_cast<StructDef>(node))
+        {
+            if (types->createStructType(structDef) == nullptr)
+            {
+                error(*structDef, "redefined struct '" + std::string(structDef->name.str()) + "'");
+            }
+        }
+    }
+
+    for (const ASTNode *node : program.globalStatements)
+    {
+        switch (node->getKind())
+        {
+        case ASTKind::StructDef:
+        {
+            const SemanticType *structType = types->getStructType(cast<StructDef>(node)->name);
+            // 重复定义的结构体没有自己的类型
+            if (structType->getStructDef() == node)
+            {
+                declareStructLayout(structType);
+            }
+            break;
+        }
+        case ASTKind::FunctionDef:
+        {
+            auto func = cast<FunctionDef>(node);
+
+            SymbolTable::Symbol symbol;
+            symbol.kind = SymbolTable::SymbolKind::FUNCTION;
+            symbol.name = func->name;
+            symbol.declaration = func;
+            symbol.type = declareSignature(func->params, func->returnType);
+
+            if (!globalScope.addSymbol(symbol))
+            {
+                error(*func, "redefined function '" + std::string(func->name.str()) + "'");
+            }
+            break;
+        }
+        case ASTKind::StructImpl:
+        {
+            auto impl = cast<StructImpl>(node);
+            for (const MemberFunctionDef *method : impl->methods)
+            {
+                if (!methods.emplace(getMethodKey(impl->structName, method->name), Method{method, declareSignature(method->params, method->returnType)}).second)
+                {
+                    error(*method, "redefined method '" + std::string(method->name.str()) + "' of struct '" + std::string(impl->structName.str()) + "'");
+                }
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    // 全局变量的初始值可以调用任何函数，但只能使用之前定义的全局变量
+    for (const ASTNode *node : program.globalStatements)
+    {
+        if (auto var = dyn_cast<GlobalVarDef>(node))
+        {
+            declareGlobalVariable(*var);
+        }
+    }
+}
+
+void Analyzer::declareStructLayout(const SemanticType *structType)
+{
+    if (structType->getLayout() != nullptr)
+    {
+        return;
+    }
+
+    const StructDef &structDef = *structType->getStructDef();
+    layoutStack.push_back(structType);
+
+    std::vector<const SemanticType *> memberTypes;
+    memberTypes.reserve(structDef.members.size());
+
+    for (const MemberVarDef *member : structDef.members)
+    {
+        const SemanticType *memberType = resolveType(member->type);
+
+        // 按值包含的结构体先计算布局，正在计算的结构体说明它直接或间接地包含了自己
+        if (memberType->isStruct())
+        {
+            if (std::find(layoutStack.begin(), layoutStack.end(), memberType) != layoutStack.end())
+            {
+                error(*member, "struct '" + std::string(structDef.name.str()) + "' contains itself through member '" + std::string(member->name.str()) + "'");
+                memberType = types->getErrorType();
+            }
+            else
+            {
+                declareStructLayout(memberType);
+            }
+        }
+
+        memberTypes.push_back(memberType);
+    }
+
+    const StructLayout *layout = types->createStructLayout(structType, memberTypes);
+    layoutStack.pop_back();
+
+    for (uint32_t i = 0; i < structDef.members.size(); i++)
+    {
+        if (layout->getMemberIndex(structDef.members[i]->name) != i)
+        {
+            error(*structDef.members[i], "duplicate member '" + std::string(structDef.members[i]->name.str()) + "' in struct '" + std::string(structDef.name.str()) + "'");
+        }
+    }
+}
+
+void Analyzer::declareGlobalVariable(const GlobalVarDef &var)
+{
+    const SemanticType *type = var.type != nullptr ? resolveType(var.type) : types->getErrorType();
+    const SemanticType *initType = checkExpr(*var.initValue);
+
+    if (var.type != nullptr)
+    {
+        expectAssignable(*var.initValue, type, initType, "initial value of '" + std::string(var.name.str()) + "'");
+    }
+    else
+    {
+        type = types->concretize(initType);
+    }
+
+    SymbolTable::Symbol symbol;
+    symbol.kind = SymbolTable::SymbolKind::VARIABLE;
+    symbol.name = var.name;
+    symbol.declaration = &var;
+    symbol.type = type;
+
+    if (!globalScope.addSymbol(symbol))
+    {
+        error(var, "redefined global '" + std::string(var.name.str()) + "'");
+    }
+}
+
+const SemanticType *Analyzer::declareSignature(const ASTList<Param *> &params, const Type *returnType)
+{
+    signatureTypes.clear();
+    for (const Param *param : params)
+    {
+        signatureTypes.push_back(resolveType(param->type));
+    }
+
+    // 没有写出返回类型的函数不检查返回值
+    return types->getFunctionType(resolveType(returnType), signatureTypes);
+}
+
+void Analyzer::declareParams(const ASTList<Param *> &params, std::span<const SemanticType *const> paramTypes)
+{
+    for (size_t i = 0; i < params.size(); i++)
+    {
+        const Param *param = params[i];
+
+        SymbolTable::Symbol symbol;
+        symbol.kind = SymbolTable::SymbolKind::PARAMETER;
+        symbol.name = param->name;
+        symbol.declaration = param;
+        symbol.type = paramTypes[i];
+        // 参数按值传递时不能修改，只能通过 &mut 引用修改
+        symbol.isMutable = symbol.type->isMutReference();
+
+        if (param->defaultValue != nullptr)
+        {
+            expectAssignable(*param->defaultValue, symbol.type, checkExpr(*param->defaultValue), "default value of '" + std::string(param->name.str()) + "'");
+        }
+
+        if (!localScopes.addSymbol(symbol))
+        {
+            error(*param, "duplicate parameter '" + std::string(param->name.str()) + "'", param->name.str().size());
+        }
+    }
+}
+
+/* 函数体 */
+
+void Analyzer::collectFunctionBodies(const Program &program, std::vector<FunctionBody> &bodies) const
+{
+    for (const ASTNode *node : program.globalStatements)
+    {
+        switch (node->getKind())
+        {
+        case ASTKind::FunctionDef:
+        {
+            auto func = cast<FunctionDef>(node);
+            const SymbolTable::Symbol *symbol = globalScope.lookup(func->name);
+            // 重复定义的函数没有自己的符号，只检查第一个定义
+            if (symbol != nullptr && symbol->declaration == func)
+            {
+                bodies.push_back({&func->params, symbol->type, func->body, nullptr, NameId()});
+            }
+            break;
+        }
+        case ASTKind::StructImpl:
+        {
+            auto impl = cast<StructImpl>(node);
+            for (const MemberFunctionDef *method : impl->methods)
+            {
+                const Method *entry = findMethod(impl->structName, method->name);
+                if (entry != nullptr && entry->definition == method)
+                {
+                    bodies.push_back({&method->params, entry->type, method->body, method->selfParam, impl->structName});
+                }
+            }
+            break;
+        }
+        default:
+            // 结构体和全局变量在 declareGlobals 中已经检查过
+            break;
+        }
+    }
+}
+
+void Analyzer::checkFunctionsInParallel(const std::vector<FunctionBody> &bodies, size_t threadCount)
+{
+    struct BodyChunk
+    {
+        size_t first = 0;
+        size_t last = 0;
+
+        std::vector<Diagnostic> diagnostics;
+    };
+
+    // 分块数量多于线程数量，先完成的线程可以继续领取下一个分块
+    const size_t chunkCount = std::min(threadCount * 4, bodies.size());
+
+    if (chunkCount <= 1)
+    {
+        for (const FunctionBody &function : bodies)
+        {
+            checkFunction(function);
+        }
+        return;
+    }
+
+    std::vector<BodyChunk> chunks(chunkCount);
+    for (size_t i = 0; i < chunkCount; i++)
+    {
+        chunks[i].first = bodies.size() * i / chunkCount;
+        chunks[i].last = bodies.size() * (i + 1) / chunkCount;
+    }
+
+    {
+        ThreadPool threadPool(std::min(threadCount, chunkCount));
+
+        for (BodyChunk &chunk : chunks)
+        {
+            threadPool.submit([this, &chunk, &bodies] {
+                // 每个线程有自己的局部作用域和临时数组，全局声明只读取
+                Analyzer analyzer(context);
+                analyzer.types = types;
+                analyzer.currentReturnType = types->getErrorType();
+                analyzer.declarations = this;
+                analyzer.diagnosticBuffer = &chunk.diagnostics;
+
+                for (size_t i = chunk.first; i < chunk.last; i++)
+                {
+                    analyzer.checkFunction(bodies[i]);
+                }
+            });
+        }
+
+        threadPool.wait();
+    }
+
+    // 分块按源代码顺序排列，依次报告后的顺序和单线程检查时相同
+    for (BodyChunk &chunk : chunks)
+    {
+        for (Diagnostic &diagnostic : chunk.diagnostics)
+        {
+            context->report(diagnostic.level, std::move(diagnostic.msg), diagnostic.position, diagnostic.length);
+        }
+    }
+}
+
+void Analyzer::checkFunction(const FunctionBody &function)
+{
+    const Stmt *body = function.body;
+    const SelfParam *selfParam = function.selfParam;
+    const SemanticType *functionType = function.type;
+
+    // 延迟解析时还没有解析的函数体不检查
+    if (body == nullptr)
+    {
+        return;
+    }
+
+    currentReturnType = functionType->getReturnType();
+
+    // 参数单独使用一层作用域，函数体中的变量可以遮蔽参数
+    localScopes.enterScope();
+
+    if (selfParam != nullptr)
+    {
+        SymbolTable::Symbol self;
+        self.kind = SymbolTable::SymbolKind::PARAMETER;
+        self.name = selfName;
+        self.declaration = selfParam;
+        self.type = selfParam->type != nullptr ? resolveType(selfParam->type) : types->getStructType(function.structName);
+        if (self.type == nullptr)
+        {
+            self.type = types->getErrorType();
+        }
+        else if (selfParam->isRef || selfParam->isMut)
+        {
+            self.type = types->getReferenceType(self.type, selfParam->isMut || self.type->isMutReference());
+        }
+        self.isMutable = self.type->isMutReference();
+        localScopes.addSymbol(self);
+    }
+
+    declareParams(*function.params, functionType->getParamTypes());
+    checkStmt(*body);
+
+    localScopes.exitScope();
+}
+
+void Analyzer::checkStmt(const Stmt &stmt)
+{
+    switch (stmt.getKind())
+    {
+    case ASTKind::CompoundStmt:
+    {
+        localScopes.enterScope();
+        for (const Stmt *statement : cast<CompoundStmt>(&stmt)->statements)
+        {
+            checkStmt(*statement);
+        }
+        localScopes.exitScope();
+        break;
+    }
+    case ASTKind::IfStmt:
+    {
+        auto ifStmt = cast<IfStmt>(&stmt);
+        checkCondition(*ifStmt->condition);
+        checkStmt(*ifStmt->thenBranch);
+        if (ifStmt->elseBranch != nullptr)
+        {
+            checkStmt(*ifStmt->elseBranch);
+        }
+        break;
+    }
+    case ASTKind::ReturnStmt:
+        checkReturnStmt(*cast<ReturnStmt>(&stmt));
+        break;
+    case ASTKind::DeclStmt:
+        checkDeclStmt(*cast<DeclStmt>(&stmt));
+        break;
+    case ASTKind::AssignStmt:
+        checkAssignStmt(*cast<AssignStmt>(&stmt));
+        break;
+    case ASTKind::ExprStmt:
+        checkExpr(*cast<ExprStmt>(&stmt)->expression);
+        break;
+    case ASTKind::ForStmt:
+    {
+        auto forStmt = cast<ForStmt>(&stmt);
+        checkExpr(*forStmt->iterable);
+
+        // 还没有迭代协议，循环变量的类型未知
+        localScopes.enterScope();
+
+        SymbolTable::Symbol loopVar;
+        loopVar.name = forStmt->loopVar;
+        loopVar.declaration = forStmt;
+        loopVar.type = types->getErrorType();
+        localScopes.addSymbol(loopVar);
+
+        checkStmt(*forStmt->body);
+        localScopes.exitScope();
+        break;
+    }
+    case ASTKind::WhileStmt:
+    {
+        auto whileStmt = cast<WhileStmt>(&stmt);
+        checkCondition(*whileStmt->condition);
+        checkStmt(*whileStmt->body);
+        break;
+    }
+    default:
+        // ErrorStmt 已经由 Parser 报告过错误
+        break;
+    }
+}
+
+void Analyzer::checkDeclStmt(const DeclStmt &decl)
+{
+    SymbolTable::Symbol symbol;
+    symbol.kind = SymbolTable::SymbolKind::VARIABLE;
+    symbol.name = decl.name;
+    symbol.declaration = &decl;
+    symbol.isMutable = decl.isMutable;
+
+    // 先检查初始值，这样 let x = x + 1; 中的 x 是外层的变量
+    if (decl.type != nullptr)
+    {
+        symbol.type = resolveType(decl.type);
+
+        if (decl.initValue != nullptr)
+        {
+            const SemanticType *initType = checkExpr(*decl.initValue);
+            const std::string what = "initial value of '" + std::string(decl.name.str()) + "'";
+
+            expectAssignable(*decl.initValue, symbol.type, initType, what);
+            if (symbol.type->isMutReference())
+            {
+                expectMutableBinding(*decl.initValue, initType, what);
+            }
+        }
+    }
+    else if (decl.initValue != nullptr)
+    {
+        symbol.type = types->concretize(checkExpr(*decl.initValue));
+    }
+    else
+    {
+        error(decl, "cannot infer the type of '" + std::string(decl.name.str()) + "' without a type or an initial value");
+    }
+
+    if (!localScopes.addSymbol(symbol))
+    {
+        error(decl, "redefined variable '" + std::string(decl.name.str()) + "' in the same scope");
+    }
+}
+
+void Analyzer::checkAssignStmt(const AssignStmt &assign)
+{
+    const SemanticType *targetType = checkExpr(*assign.target);
+    const SemanticType *valueType = checkExpr(*assign.value);
+
+    // 只能给变量和它们的成员赋值，找到最外层的变量检查它是否可变
+    if (const IdentifierExpr *identifier = getAccessRoot(*assign.target))
+    {
+        const SymbolTable::Symbol *symbol = lookup(identifier->name);
+
+        if (symbol != nullptr && !symbol->type->isError() && !isWritable(*symbol))
+        {
+            error(*assign.target, "cannot assign to immutable '" + std::string(identifier->name.str()) + "'");
+        }
+    }
+    else
+    {
+        error(*assign.target, "invalid assignment target");
+    }
+
+    // 通过引用赋值时写入的是被引用的值
+    expectAssignable(*assign.value, targetType->withoutReference(), valueType, "assigned value");
+}
+
+void Analyzer::checkReturnStmt(const ReturnStmt &ret)
+{
+    if (ret.returnValue == nullptr)
+    {
+        if (!currentReturnType->isError() && !currentReturnType->isVoid())
+        {
+            error(ret, "missing return value of type '" + currentReturnType->toString() + "'");
+        }
+        return;
+    }
+
+    const SemanticType *type = checkExpr(*ret.returnValue);
+
+    expectAssignable(*ret.returnValue, currentReturnType, type, "return value");
+}
+
+void Analyzer::checkCondition(const Expr &condition)
+{
+    const SemanticType *type = checkExpr(condition);
+
+    if (!type->isError() && !type->withoutReference()->isBool())
+    {
+        error(condition, "condition must be 'bool', found '" + type->toString() + "'");
+    }
+}
+
+/* 表达式 */
+
+const SemanticType *Analyzer::checkExpr(const Expr &expr)
+{
+    switch (expr.getKind())
+    {
+    case ASTKind::LiteralExpr:
+    {
+        switch (cast<LiteralExpr>(&expr)->type)
+        {
+        case LiteralExpr::LiteralType::Int:
+            return types->getBuiltin(SemanticType::Kind::IntLiteral);
+        case LiteralExpr::LiteralType::Float:
+            return types->getBuiltin(SemanticType::Kind::FloatLiteral);
+        case LiteralExpr::LiteralType::String:
+            return types->getBuiltin(SemanticType::Kind::String);
+        case LiteralExpr::LiteralType::Bool:
+            return types->getBoolType();
+        case LiteralExpr::LiteralType::Char:
+            return types->getCharType();
+        }
+        return types->getErrorType();
+    }
+    case ASTKind::IdentifierExpr:
+        return checkIdentifier(*cast<IdentifierExpr>(&expr));
+    case ASTKind::StructInitExpr:
+        return checkStructInit(*cast<StructInitExpr>(&expr));
+    case ASTKind::StaticMemberCall:
+    {
+        auto call = cast<StaticMemberCall>(&expr);
+        return checkMethodCall(*call, nullptr, nullptr, call->classType->typeName, call->methodName, call->arguments);
+    }
+    case ASTKind::MemberFunctionCall:
+    {
+        auto call = cast<MemberFunctionCall>(&expr);
+        const SemanticType *receiverType = checkExpr(*call->object);
+        const SemanticType *objectType = receiverType->withoutReference();
+
+        if (!objectType->isStruct())
+        {
+            if (!objectType->isError())
+            {
+                error(*call, "cannot call method '" + std::string(call->methodName.str()) + "' on type '" + objectType->toString() + "'", call->methodName.str().size());
+            }
+
+            for (const Expr *argument : call->arguments)
+            {
+                checkExpr(*argument);
+            }
+            return types->getErrorType();
+        }
+
+        return checkMethodCall(*call, call->object, receiverType, objectType->getName(), call->methodName, call->arguments);
+    }
+    case ASTKind::FunctionCall:
+        return checkFunctionCall(*cast<FunctionCall>(&expr));
+    case ASTKind::MemberAccess:
+        return checkMemberAccess(*cast<MemberAccess>(&expr));
+    case ASTKind::BinaryOp:
+        return checkBinaryOp(*cast<BinaryOp>(&expr));
+    case ASTKind::UnaryOp:
+        return checkUnaryOp(*cast<UnaryOp>(&expr));
+    case ASTKind::CastExpr:
+        return checkCast(*cast<CastExpr>(&expr));
+    case ASTKind::ParenExpr:
+        return checkExpr(*cast<ParenExpr>(&expr)->expression);
+    default:
+        // 模块限定的名字还不支持
+        return types->getErrorType();
+    }
+}
+
+const SemanticType *Analyzer::checkIdentifier(const IdentifierExpr &identifier)
+{
+    const SymbolTable::Symbol *symbol = lookup(identifier.name);
+
+    if (symbol == nullptr)
+    {
+        error(identifier, "undefined identifier '" + std::string(identifier.name.str()) + "'", identifier.name.str().size());
+        return types->getErrorType();
+    }
+
+    if (symbol->kind == SymbolTable::SymbolKind::FUNCTION)
+    {
+        error(identifier, "function '" + std::string(identifier.name.str()) + "' cannot be used as a value", identifier.name.str().size());
+        return types->getErrorType();
+    }
+
+    return symbol->type;
+}
+
+const SemanticType *Analyzer::checkBinaryOp(const BinaryOp &binary)
+{
+    // 左结合的长链 a + b + c + ... 在 AST 中向左加深，沿着左侧展开，避免递归的深度和链的长度相同
+    const size_t base = binaryChain.size();
+
+    const Expr *left = &binary;
+    while (auto op = dyn_cast<BinaryOp>(left))
+    {
+        binaryChain.push_back(op);
+        left = op->left;
+    }
+
+    const SemanticType *type = checkExpr(*left);
+
+    while (binaryChain.size() > base)
+    {
+        const BinaryOp *op = binaryChain.back();
+        binaryChain.pop_back();
+
+        type = checkBinaryOperands(*op, type, checkExpr(*op->right));
+    }
+
+    return type;
+}
+
+const SemanticType *Analyzer::checkBinaryOperands(const BinaryOp &binary, const SemanticType *left, const SemanticType *right)
+{
+    left = left->withoutReference();
+    right = right->withoutReference();
+
+    if (left->isError() || right->isError())
+    {
+        return types->getErrorType();
+    }
+
+    const std::string spelling(getBinaryOpSpelling(binary.op));
+    const SemanticType *common = unify(left, right);
+
+    if (common == nullptr)
+    {
+        error(binary, "mismatched types '" + left->toString() + "' and '" + right->toString() + "' for operator '" + spelling + "'", spelling.size());
+        return types->getErrorType();
+    }
+
+    bool valid = false;
+    const SemanticType *result = common;
+
+    switch (binary.op)
+    {
+    case BinaryOpKind::Mul:
+    case BinaryOpKind::Div:
+    case BinaryOpKind::Add:
+    case BinaryOpKind::Sub:
+        valid = common->isNumeric();
+        break;
+    case BinaryOpKind::Less:
+    case BinaryOpKind::LessEq:
+    case BinaryOpKind::Greater:
+    case BinaryOpKind::GreaterEq:
+        valid = common->isNumeric() || common->isChar();
+        result = types->getBoolType();
+        break;
+    case BinaryOpKind::Equal:
+    case BinaryOpKind::NotEqual:
+        valid = !common->isStruct() && !common->isVoid();
+        result = types->getBoolType();
+        break;
+    case BinaryOpKind::BitAnd:
+    case BinaryOpKind::BitOr:
+        valid = common->isInteger() || common->isBool();
+        break;
+    case BinaryOpKind::LogicalAnd:
+    case BinaryOpKind::LogicalOr:
+        valid = common->isBool();
+        break;
+    }
+
+    if (!valid)
+    {
+        error(binary, "operator '" + spelling + "' cannot be applied to '" + common->toString() + "'", spelling.size());
+        return types->getErrorType();
+    }
+
+    return result;
+}
+
+const SemanticType *Analyzer::checkUnaryOp(const UnaryOp &unary)
+{
+    const SemanticType *operand = checkExpr(*unary.operand)->withoutReference();
+
+    if (operand->isError())
+    {
+        return operand;
+    }
+
+    const bool valid = unary.op == UnaryOpKind::Not ? operand->isBool() : operand->isNumeric();
+
+    if (!valid)
+    {
+        error(unary, "operator '" + std::string(getUnaryOpSpelling(unary.op)) + "' cannot be applied to '" + operand->toString() + "'");
+        return types->getErrorType();
+    }
+
+    return operand;
+}
+
+const SemanticType *Analyzer::checkCast(const CastExpr &castExpr)
+{
+    const SemanticType *target = resolveType(castExpr.targetType);
+    const SemanticType *source = checkExpr(*castExpr.expression)->withoutReference();
+
+    if (target->isError() || source->isError())
+    {
+        return target;
+    }
+
+    // 只能在数字、 bool 和 char 之间转换
+    auto isScalar = [](const SemanticType *type) { return type->isNumeric() || type->isBool() || type->isChar(); };
+
+    if (!isScalar(target) || !isScalar(source))
+    {
+        error(castExpr, "cannot cast '" + source->toString() + "' to '" + target->toString() + "'");
+    }
+
+    return target;
+}
+
+const SemanticType *Analyzer::checkStructInit(const StructInitExpr &init)
+{
+    const NameId structName = init.structType->typeName;
+    const SemanticType *structType = types->getStructType(structName);
+
+    if (structType == nullptr)
+    {
+        error(init, "undefined struct '" + std::string(structName.str()) + "'", structName.str().size());
+
+        for (const MemberInit &memberInit : init.memberInits)
+        {
+            checkExpr(*memberInit.value);
+        }
+        return types->getErrorType();
+    }
+
+    const StructLayout &layout = *structType->getLayout();
+
+    // 成员初始值中可能还有结构体初始化，先记下这一层使用的范围
+    const size_t base = initializedMembers.size();
+    initializedMembers.resize(base + layout.getMemberCount(), false);
+
+    for (const MemberInit &memberInit : init.memberInits)
+    {
+        const SemanticType *valueType = checkExpr(*memberInit.value);
+        const uint32_t index = layout.getMemberIndex(memberInit.name);
+
+        if (index == StructLayout::NO_MEMBER)
+        {
+            error(*memberInit.value, "struct '" + std::string(structName.str()) + "' has no member '" + std::string(memberInit.name.str()) + "'");
+            continue;
+        }
+
+        if (initializedMembers[base + index])
+        {
+            error(*memberInit.value, "member '" + std::string(memberInit.name.str()) + "' is initialized more than once");
+        }
+        initializedMembers[base + index] = true;
+
+        expectAssignable(*memberInit.value, layout.getMember(index).type, valueType, "member '" + std::string(memberInit.name.str()) + "'");
+    }
+
+    for (uint32_t i = 0; i < layout.getMemberCount(); i++)
+    {
+        const NameId memberName = layout.getMember(i).name;
+
+        // 重复的成员在声明时已经报告过错误
+        if (!initializedMembers[base + i] && layout.getMemberIndex(memberName) == i)
+        {
+            error(init, "missing member '" + std::string(memberName.str()) + "' in initializer of '" + std::string(structName.str()) + "'", structName.str().size());
+        }
+    }
+
+    initializedMembers.resize(base);
+    return structType;
+}
+
+const SemanticType *Analyzer::checkMemberAccess(const MemberAccess &access)
+{
+    const SemanticType *objectType = checkExpr(*access.object)->withoutReference();
+
+    if (objectType->isError())
+    {
+        return objectType;
+    }
+
+    const StructLayout *layout = objectType->getLayout();
+    const uint32_t index = layout != nullptr ? layout->getMemberIndex(access.memberName) : StructLayout::NO_MEMBER;
+
+    if (index == StructLayout::NO_MEMBER)
+    {
+        error(access, "type '" + objectType->toString() + "' has no member '" + std::string(access.memberName.str()) + "'", access.memberName.str().size());
+        return types->getErrorType();
+    }
+
+    return layout->getMember(index).type;
+}
+
+const SemanticType *Analyzer::checkFunctionCall(const FunctionCall &call)
+{
+    auto callee = dyn_cast<IdentifierExpr>(call.function);
+    const SymbolTable::Symbol *symbol = callee != nullptr ? lookup(callee->name) : nullptr;
+
+    if (symbol == nullptr || symbol->kind != SymbolTable::SymbolKind::FUNCTION)
+    {
+        if (callee != nullptr)
+        {
+            const std::string name(callee->name.str());
+            error(call, symbol == nullptr ? "undefined function '" + name + "'" : "'" + name + "' is not a function", name.size());
+        }
+
+        for (const Expr *argument : call.arguments)
+        {
+            checkExpr(*argument);
+        }
+        return types->getErrorType();
+    }
+
+    auto func = cast<FunctionDef>(symbol->declaration);
+
+    checkArguments(call, func->name, func->params, symbol->type->getParamTypes(), call.arguments);
+    return symbol->type->getReturnType();
+}
+
+const SemanticType *Analyzer::checkMethodCall(const ASTNode &call, const Expr *receiver, const SemanticType *receiverType, NameId structName, NameId methodName, const ASTList<Expr *> &arguments)
+{
+    const Method *method = findMethod(structName, methodName);
+
+    if (method == nullptr)
+    {
+        error(call, "struct '" + std::string(structName.str()) + "' has no method '" + std::string(methodName.str()) + "'");
+
+        for (const Expr *argument : arguments)
+        {
+            checkExpr(*argument);
+        }
+        return types->getErrorType();
+    }
+
+    // 接收 &mut self 的成员函数可以修改对象，对象和参数一样必须可变
+    const SelfParam *selfParam = method->definition->selfParam;
+    const bool mutableSelf = selfParam != nullptr && (selfParam->isMut || (selfParam->type != nullptr && selfParam->type->isMutReference));
+
+    if (receiver != nullptr && mutableSelf)
+    {
+        const std::string what = "'&mut self' of method '" + std::string(methodName.str()) + "'";
+
+        if (receiverType->isReference() && !receiverType->isMutReference())
+        {
+            error(*receiver, "cannot pass '" + receiverType->toString() + "' as " + what);
+        }
+        expectMutableBinding(*receiver, receiverType, what);
+    }
+
+    checkArguments(call, methodName, method->definition->params, method->type->getParamTypes(), arguments);
+    return method->type->getReturnType();
+}
+
+void Analyzer::checkArguments(const ASTNode &call, NameId calleeName, const ASTList<Param *> &params, std::span<const SemanticType *const> paramTypes, const ASTList<Expr *> &arguments)
+{
+    // 有默认值的参数可以省略
+    size_t required = 0;
+    for (const Param *param : params)
+    {
+        if (param->defaultValue == nullptr)
+        {
+            required++;
+        }
+    }
+
+    if (arguments.size() < required || arguments.size() > params.size())
+    {
+        const std::string expected = required == params.size() ? std::to_string(required) : std::to_string(required) + " to " + std::to_string(params.size());
+        error(call, "'" + std::string(calleeName.str()) + "' expects " + expected + " arguments but got " + std::to_string(arguments.size()), calleeName.str().size());
+    }
+
+    for (size_t i = 0; i < arguments.size(); i++)
+    {
+        const SemanticType *argumentType = checkExpr(*arguments[i]);
+
+        if (i < params.size())
+        {
+            const std::string what = "argument '" + std::string(params[i]->name.str()) + "'";
+
+            expectAssignable(*arguments[i], paramTypes[i], argumentType, what);
+            if (paramTypes[i]->isMutReference())
+            {
+                expectMutableBinding(*arguments[i], argumentType, what);
+            }
+        }
+    }
+}
+
+/* 类型 */
+
+const SemanticType *Analyzer::resolveType(const Type *type)
+{
+    if (type == nullptr)
+    {
+        return types->getErrorType();
+    }
+
+    const SemanticType *result = type->kind == Type::TypeKind::Primitive ? types->getPrimitive(type->typeName) : types->getStructType(type->typeName);
+
+    if (result == nullptr)
+    {
+        error(*type, "undefined type '" + std::string(type->typeName.str()) + "'", type->typeName.str().size());
+        return types->getErrorType();
+    }
+
+    if (type->isReference || type->isMutReference)
+    {
+        result = types->getReferenceType(result, type->isMutReference);
+    }
+    return result;
+}
+
+const IdentifierExpr *Analyzer::getAccessRoot(const Expr &expr)
+{
+    const Expr *root = &expr;
+    while (auto access = dyn_cast<MemberAccess>(root))
+    {
+        root = access->object;
+    }
+
+    return dyn_cast<IdentifierExpr>(root);
+}
+
+bool Analyzer::isWritable(const SymbolTable::Symbol &symbol)
+{
+    // 通过 &T 访问到的值和成员同样不可变
+    return symbol.isMutable && (!symbol.type->isReference() || symbol.type->isMutReference());
+}
+
+void Analyzer::expectMutableBinding(const Expr &value, const SemanticType *valueType, std::string_view what)
+{
+    const IdentifierExpr *identifier = getAccessRoot(value);
+
+    if (valueType->isReference() || identifier == nullptr)
+    {
+        return;
+    }
+
+    const SymbolTable::Symbol *symbol = lookup(identifier->name);
+
+    if (symbol != nullptr && !symbol->type->isError() && !isWritable(*symbol))
+    {
+        error(value, "cannot pass immutable '" + std::string(identifier->name.str()) + "' as " + std::string(what));
+    }
+}
+
+bool Analyzer::isAssignable(const SemanticType *target, const SemanticType *source)
+{
+    if (target->isMutReference() && source->isReference() && !source->isMutReference())
+    {
+        return false;
+    }
+
+    return unify(target->withoutReference(), source->withoutReference()) == target->withoutReference() || target->isError() || source->isError();
+}
+
+const SemanticType *Analyzer::unify(const SemanticType *left, const SemanticType *right)
+{
+    if (left->isError() || right->isError())
+    {
+        return left->isError() ? left : right;
+    }
+
+    if (left == right)
+    {
+        return left;
+    }
+
+    // 字面量先转换成另一侧确定的类型，两侧都是字面量时整数转换成浮点数
+    if (left->getKind() == SemanticType::Kind::IntLiteral && right->isNumeric())
+    {
+        return right;
+    }
+    if (right->getKind() == SemanticType::Kind::IntLiteral && left->isNumeric())
+    {
+        return left;
+    }
+    if (left->getKind() == SemanticType::Kind::FloatLiteral && right->isFloat())
+    {
+        return right;
+    }
+    if (right->getKind() == SemanticType::Kind::FloatLiteral && left->isFloat())
+    {
+        return left;
+    }
+
+    return nullptr;
+}
+
+void Analyzer::expectAssignable(const ASTNode &node, const SemanticType *target, const SemanticType *source, std::string_view what)
+{
+    if (!isAssignable(target, source))
+    {
+        error(node, "mismatched types for " + std::string(what) + ": expected '" + target->toString() + "', found '" + source->toString() + "'");
+    }
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "Analyzer/SymbolTable.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+SymbolTable::SymbolTable()
+{
+    slots.resize(256);
+    scopeStarts.push_back(0);
+}
+
+void SymbolTable::enterScope()
+{
+    scopeStarts.push_back(static_cast<uint32_t>(entries.size()));
+}
+
+void SymbolTable::exitScope()
+{
+    if (scopeStarts.size() <= 1)
+    {
+        throw std::logic_error("SymbolTable cannot exit the global scope");
+    }
+
+    const uint32_t start = scopeStarts.back();
+    scopeStarts.pop_back();
+
+    // 按加入的相反顺序撤销，同一个作用域中不会有同名的符号，所以每个槽位只需要恢复一次
+    while (entries.size() > start)
+    {
+        const Entry &entry = entries.back();
+        findSlot(entry.symbol.name).head = entry.shadowed;
+        entries.pop_back();
+    }
+}
+
+bool SymbolTable::addSymbol(const Symbol &symbol)
+{
+    // 空名字用来表示空槽位，不能作为符号的名字
+    if (symbol.name.empty())
+    {
+        return false;
+    }
+
+    // 保持装载因子不超过 1/2
+    if ((usedSlots + 1) * 2 > slots.size())
+    {
+        grow();
+    }
+
+    Slot &slot = findSlot(symbol.name);
+    const uint32_t depth = static_cast<uint32_t>(scopeStarts.size());
+
+    if (slot.head != NO_ENTRY && entries[slot.head].depth == depth)
+    {
+        return false;
+    }
+
+    if (slot.name.empty())
+    {
+        slot.name = symbol.name;
+        usedSlots++;
+    }
+
+    Entry &entry = entries.emplace_back();
+    entry.symbol = symbol;
+    entry.symbol.isGlobal = depth == 1;
+    entry.shadowed = slot.head;
+    entry.depth = depth;
+
+    slot.head = static_cast<uint32_t>(entries.size() - 1);
+    return true;
+}
+
+SymbolTable::Symbol *SymbolTable::lookup(NameId name)
+{
+    const Slot &slot = findSlot(name);
+    return slot.head == NO_ENTRY ? nullptr : &entries[slot.head].symbol;
+}
+
+const SymbolTable::Symbol *SymbolTable::lookup(NameId name) const
+{
+    const Slot &slot = findSlot(name);
+    return slot.head == NO_ENTRY ? nullptr : &entries[slot.head].symbol;
+}
+
+SymbolTable::Symbol *SymbolTable::lookupCurrentScope(NameId name)
+{
+    const Slot &slot = findSlot(name);
+
+    if (slot.head == NO_ENTRY || entries[slot.head].depth != scopeStarts.size())
+    {
+        return nullptr;
+    }
+
+    return &entries[slot.head].symbol;
+}
+
+bool SymbolTable::addStruct(const StructDef *structDef)
+{
+    return structs.emplace(structDef->name, structDef).second;
+}
+
+const StructDef *SymbolTable::getStruct(NameId name) const
+{
+    auto it = structs.find(name);
+    return it == structs.end() ? nullptr : it->second;
+}
+
+SymbolTable::Slot &SymbolTable::findSlot(NameId name)
+{
+    return const_cast<Slot &>(std::as_const(*this).findSlot(name));
+}
+
+const SymbolTable::Slot &SymbolTable::findSlot(NameId name) const
+{
+    const size_t mask = slots.size() - 1;
+
+    for (size_t index = name.hash() & mask;; index = (index + 1) & mask)
+    {
+        const Slot &slot = slots[index];
+
+        if (slot.name == name || slot.name.empty())
+        {
+            return slot;
+        }
+    }
+}
+
+void SymbolTable::grow()
+{
+    std::vector<Slot> oldSlots = std::move(slots);
+    slots.assign(oldSlots.size() * 2, Slot{});
+
+    for (const Slot &slot : oldSlots)
+    {
+        if (!slot.name.empty())
+        {
+            findSlot(slot.name) = slot;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,259 @@
+#include "Analyzer/Types.hpp"
+
+#include "Parser/AST.hpp"
+
+#include <algorithm>
+
+// 基本类型的名字，顺序和 SemanticType::Kind 中的基本类型相同
+static constexpr std::array<std::string_view, 8> primitiveNames = {"i8", "i16", "i32", "i64", "f32", "f64", "bool", "char"};
+
+std::string SemanticType::toString() const
+{
+    switch (kind)
+    {
+    case Kind::Error:
+        return "<error>";
+    case Kind::Void:
+        return "void";
+    case Kind::IntLiteral:
+        return "{integer}";
+    case Kind::FloatLiteral:
+        return "{float}";
+    case Kind::String:
+        return "string";
+    case Kind::Struct:
+        return std::string(name.str());
+    case Kind::Reference:
+        return (mutableReference ? "&mut " : "&") + element->toString();
+    case Kind::Function:
+    {
+        std::string result = "fn(";
+        for (size_t i = 0; i < paramTypes.size(); i++)
+        {
+            if (i != 0)
+            {
+                result += ", ";
+            }
+            result += paramTypes[i]->toString();
+        }
+        return result + ") -> " + element->toString();
+    }
+    default:
+        return std::string(primitiveNames[static_cast<size_t>(kind) - static_cast<size_t>(Kind::I8)]);
+    }
+}
+
+uint32_t StructLayout::getMemberIndex(NameId name) const
+{
+    if (memberSlots.empty())
+    {
+        return NO_MEMBER;
+    }
+
+    const size_t mask = memberSlots.size() - 1;
+
+    for (size_t index = name.hash() & mask;; index = (index + 1) & mask)
+    {
+        const uint32_t member = memberSlots[index];
+
+        if (member == NO_MEMBER || members[member].name == name)
+        {
+            return member;
+        }
+    }
+}
+
+TypeContext::TypeContext()
+{
+    for (size_t i = 0; i < builtins.size(); i++)
+    {
+        builtins[i] = &create(static_cast<SemanticType::Kind>(i));
+    }
+
+    for (size_t i = 0; i < primitiveNames.size(); i++)
+    {
+        primitivesByName.emplace(NameId::get(primitiveNames[i]), builtins[static_cast<size_t>(SemanticType::Kind::I8) + i]);
+    }
+}
+
+const SemanticType *TypeContext::getPrimitive(NameId name) const
+{
+    auto it = primitivesByName.find(name);
+    return it == primitivesByName.end() ? nullptr : it->second;
+}
+
+const SemanticType *TypeContext::createStructType(const StructDef *structDef)
+{
+    auto [it, inserted] = structs.emplace(structDef->name, nullptr);
+
+    if (!inserted)
+    {
+        return nullptr;
+    }
+
+    SemanticType &type = create(SemanticType::Kind::Struct);
+    type.name = structDef->name;
+    type.structDef = structDef;
+
+    it->second = &type;
+    return &type;
+}
+
+const SemanticType *TypeContext::getStructType(NameId name) const
+{
+    auto it = structs.find(name);
+    return it == structs.end() ? nullptr : it->second;
+}
+
+const StructLayout *TypeContext::createStructLayout(const SemanticType *structType, std::span<const SemanticType *const> memberTypes)
+{
+    const StructDef *structDef = structType->getStructDef();
+    StructLayout &layout = layouts.emplace_back();
+    layout.members.reserve(memberTypes.size());
+
+    uint64_t offset = 0;
+    for (size_t i = 0; i < memberTypes.size(); i++)
+    {
+        const uint64_t alignment = getAlignmentOf(memberTypes[i]);
+        offset = (offset + alignment - 1) / alignment * alignment;
+
+        layout.members.push_back({structDef->members[i]->name, memberTypes[i], offset});
+        layout.alignment = std::max(layout.alignment, alignment);
+        offset += getSizeOf(memberTypes[i]);
+    }
+    layout.size = (offset + layout.alignment - 1) / layout.alignment * layout.alignment;
+
+    // 装载因子不超过 1/2
+    size_t capacity = 1;
+    while (capacity < layout.members.size() * 2)
+    {
+        capacity *= 2;
+    }
+    layout.memberSlots.assign(capacity, StructLayout::NO_MEMBER);
+
+    const size_t mask = capacity - 1;
+    for (uint32_t i = 0; i < layout.members.size(); i++)
+    {
+        size_t index = layout.members[i].name.hash() & mask;
+        while (layout.memberSlots[index] != StructLayout::NO_MEMBER && layout.members[layout.memberSlots[index]].name != layout.members[i].name)
+        {
+            index = (index + 1) & mask;
+        }
+
+        if (layout.memberSlots[index] == StructLayout::NO_MEMBER)
+        {
+            layout.memberSlots[index] = i;
+        }
+    }
+
+    // 布局在收集全局声明时设置一次，之后不再改变
+    structs.at(structType->getName())->layout = &layout;
+    return &layout;
+}
+
+uint64_t TypeContext::getSizeOf(const SemanticType *type)
+{
+    switch (type->getKind())
+    {
+    case SemanticType::Kind::I8:
+    case SemanticType::Kind::Bool:
+    case SemanticType::Kind::Char:
+        return 1;
+    case SemanticType::Kind::I16:
+        return 2;
+    case SemanticType::Kind::I32:
+    case SemanticType::Kind::F32:
+        return 4;
+    case SemanticType::Kind::I64:
+    case SemanticType::Kind::F64:
+    case SemanticType::Kind::String:
+    case SemanticType::Kind::Reference:
+    case SemanticType::Kind::Function:
+        // 字符串、引用和函数都通过指针保存
+        return 8;
+    case SemanticType::Kind::Struct:
+        return type->getLayout() != nullptr ? type->getLayout()->getSize() : 0;
+    default:
+        return 0;
+    }
+}
+
+uint64_t TypeContext::getAlignmentOf(const SemanticType *type)
+{
+    if (type->isStruct())
+    {
+        return type->getLayout() != nullptr ? type->getLayout()->getAlignment() : 1;
+    }
+
+    return std::max<uint64_t>(getSizeOf(type), 1);
+}
+
+const SemanticType *TypeContext::getReferenceType(const SemanticType *pointee, bool isMutable)
+{
+    if (pointee->isReference() || pointee->isError())
+    {
+        return pointee;
+    }
+
+    // 类型至少按指针大小对齐，最低位用来区分是否可变
+    const uintptr_t key = reinterpret_cast<uintptr_t>(pointee) | (isMutable ? 1 : 0);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto [it, inserted] = references.emplace(key, nullptr);
+
+    if (inserted)
+    {
+        SemanticType &type = create(SemanticType::Kind::Reference);
+        type.element = pointee;
+        type.mutableReference = isMutable;
+        it->second = &type;
+    }
+
+    return it->second;
+}
+
+const SemanticType *TypeContext::getFunctionType(const SemanticType *returnType, std::span<const SemanticType *const> paramTypes)
+{
+    size_t hash = std::hash<const void *>()(returnType);
+    for (const SemanticType *param : paramTypes)
+    {
+        hash = hash * 31 + std::hash<const void *>()(param);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto [begin, end] = functions.equal_range(hash);
+    for (auto it = begin; it != end; ++it)
+    {
+        const SemanticType *candidate = it->second;
+        if (candidate->element == returnType && std::equal(paramTypes.begin(), paramTypes.end(), candidate->paramTypes.begin(), candidate->paramTypes.end()))
+        {
+            return candidate;
+        }
+    }
+
+    SemanticType &type = create(SemanticType::Kind::Function);
+    type.element = returnType;
+    type.paramTypes.assign(paramTypes.begin(), paramTypes.end());
+
+    functions.emplace(hash, &type);
+    return &type;
+}
+
+const SemanticType *TypeContext::concretize(const SemanticType *type) const
+{
+    switch (type->getKind())
+    {
+    case SemanticType::Kind::IntLiteral:
+        return getBuiltin(SemanticType::Kind::I32);
+    case SemanticType::Kind::FloatLiteral:
+        return getBuiltin(SemanticType::Kind::F64);
+    default:
+        return type;
+    }
+}
+
+SemanticType &TypeContext::create(SemanticType::Kind kind)
+{
+    return types.emplace_back(SemanticType::CreationKey(), kind);
+}
\ No newline at end of file
@@ -1,21 +1,30 @@
 #include "Core/CompilePipeline.hpp"
 
+#include "Analyzer/Analyzer.hpp"
 #include "Lexer/Lexer.hpp"
+#include "Logger/Logger.hpp"
 #include "Parser/Parser.hpp"
 
-#include <fstream>
-#include <iostream>
-#include <sstream>
-
 CompilePipeline::CompilePipeline(std::shared_ptr<Context> cnt)
 {
     context = std::move(cnt);
 
-    std::ifstream f{context->filePath, std::ios::binary};
-    std::stringstream ss;
-    ss << f.rdbuf();
-    context->fileValue = ss.str();
+    // 源代码可以提前通过 Context::setSource 提供，否则从 filePath 加载
+    if (context->fileValue.data() == nullptr && !context->loadSource())
+    {
+        Logger::Log(Logger::LogLevel::ERROR, context->filePath, "cannot open source file");
+    }
+
+    // 流式模式下由 Parser 驱动 Lexer
+    if (!context->options.streamingLexer)
+    {
+        passes.emplace_back(std::make_unique<Lexer>(context));
+    }
 
-    passes.emplace_back(std::make_unique<Lexer>(context));
     passes.emplace_back(std::make_unique<Parser>(context));
+
+    if (!context->options.syntaxOnly)
+    {
+        passes.emplace_back(std::make_unique<Analyzer>(context));
+    }
 }
\ No newline at end of file
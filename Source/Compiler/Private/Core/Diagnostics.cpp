@@ -0,0 +1,28 @@
+#include "Core/Diagnostics.hpp"
+
+void DiagnosticEngine::report(Logger::LogLevel level, const Logger::LogInfo &info)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    diagnostics.push_back({level, info.msg, info.position, info.length});
+
+    if (level == Logger::LogLevel::ERROR)
+    {
+        errorCount++;
+    }
+
+    // 持有锁时输出，不同线程的信息不会交错
+    Logger::Print(level, info);
+}
+
+size_t DiagnosticEngine::getErrorCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return errorCount;
+}
+
+std::vector<Diagnostic> DiagnosticEngine::getDiagnostics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return diagnostics;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "Core/LineTable.hpp"
+#include "Lexer/Scanner.hpp"
+
+#include <algorithm>
+
+void LineTable::build(std::string_view source)
+{
+    const char *begin = source.data();
+    const char *end = begin + source.size();
+
+    lineStarts.clear();
+    lineStarts.reserve(Scanner::countNewlines(begin, end) + 1);
+    lineStarts.push_back(0);
+
+    for (const char *p = Scanner::findByte(begin, end, '\n'); p != end; p = Scanner::findByte(p + 1, end, '\n'))
+    {
+        lineStarts.push_back(p - begin + 1);
+    }
+}
+
+SourceLocation LineTable::getLocation(std::string_view source, size_t offset)
+{
+    if (!isBuilt())
+    {
+        build(source);
+    }
+
+    // 第一个大于 offset 的行首的前一行就是 offset 所在的行
+    auto it = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+    size_t line = it - lineStarts.begin();
+
+    SourceLocation location;
+    location.line = line;
+    location.lineStart = lineStarts[line - 1];
+    location.col = offset - location.lineStart + 1;
+    return location;
+}
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "Core/SourceManager.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SourceFile::~SourceFile()
+{
+    if (mapping == nullptr)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(mapping);
+#else
+    munmap(mapping, mappingSize);
+#endif
+}
+
+// 映射区域中文件结尾之后到页末尾的部分由系统填充为 0 ，只要这部分足够放下结尾标记，就不需要复制文件
+static bool hasRoomForPadding(size_t size, size_t pageSize)
+{
+    const size_t remainder = size % pageSize;
+    return remainder != 0 && pageSize - remainder >= SourceFile::PADDING_SIZE;
+}
+
+#ifdef _WIN32
+bool SourceFile::map()
+{
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+
+    if (!GetFileSizeEx(file, &fileSize) || !hasRoomForPadding(fileSize.QuadPart, systemInfo.dwPageSize))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (fileMapping == nullptr)
+    {
+        return false;
+    }
+
+    // 映射视图会保持映射对象存活，句柄可以直接关闭
+    void *view = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(fileMapping);
+
+    if (view == nullptr)
+    {
+        return false;
+    }
+
+    mapping = view;
+    mappingSize = fileSize.QuadPart;
+    content = std::string_view(static_cast<const char *>(view), mappingSize);
+    return true;
+}
+#else
+bool SourceFile::map()
+{
+    int fd = open(path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStat;
+
+    if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || !hasRoomForPadding(fileStat.st_size, sysconf(_SC_PAGESIZE)))
+    {
+        close(fd);
+        return false;
+    }
+
+    void *view = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (view == MAP_FAILED)
+    {
+        return false;
+    }
+
+#ifdef MADV_SEQUENTIAL
+    // 词法分析器只会从头到尾读一遍文件
+    madvise(view, fileStat.st_size, MADV_SEQUENTIAL);
+#endif
+
+    mapping = view;
+    mappingSize = fileStat.st_size;
+    content = std::string_view(static_cast<const char *>(view), mappingSize);
+    return true;
+}
+#endif
+
+bool SourceFile::read()
+{
+    std::ifstream file{path, std::ios::binary | std::ios::ate};
+
+    if (!file)
+    {
+        return false;
+    }
+
+    const std::streamoff size = file.tellg();
+
+    if (size < 0)
+    {
+        return false;
+    }
+
+    // 一次分配好包括结尾标记在内的全部空间，只读一遍文件
+    storage = std::make_unique<char[]>(size + PADDING_SIZE);
+    file.seekg(0);
+
+    if (!file.read(storage.get(), size))
+    {
+        storage.reset();
+        return false;
+    }
+
+    std::memset(storage.get() + size, 0, PADDING_SIZE);
+    content = std::string_view(storage.get(), size);
+    return true;
+}
+
+void SourceFile::assign(std::string_view code)
+{
+    storage = std::make_unique<char[]>(code.size() + PADDING_SIZE);
+    std::memcpy(storage.get(), code.data(), code.size());
+    std::memset(storage.get() + code.size(), 0, PADDING_SIZE);
+    content = std::string_view(storage.get(), code.size());
+}
+
+std::optional<uint16_t> SourceManager::loadFile(const std::string &path)
+{
+    auto file = std::make_unique<SourceFile>();
+    file->path = path;
+
+    if (!file->map() && !file->read())
+    {
+        return std::nullopt;
+    }
+
+    return addFile(std::move(file));
+}
+
+uint16_t SourceManager::addBuffer(const std::string &path, std::string_view code)
+{
+    auto file = std::make_unique<SourceFile>();
+    file->path = path;
+    file->assign(code);
+
+    return addFile(std::move(file));
+}
+
+uint16_t SourceManager::addFile(std::unique_ptr<SourceFile> file)
+{
+    // Token::fileId 只有 16 位
+    if (files.size() > UINT16_MAX)
+    {
+        throw std::length_error("Too many source files");
+    }
+
+    files.push_back(std::move(file));
+    return files.size() - 1;
+}
\ No newline at end of file
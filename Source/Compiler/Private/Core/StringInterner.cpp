@@ -0,0 +1,146 @@
+#include "Core/StringInterner.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+StringInterner &StringInterner::getInstance()
+{
+    static StringInterner interner;
+    return interner;
+}
+
+NameId StringInterner::intern(std::string_view text)
+{
+    if (text.empty())
+    {
+        return NameId();
+    }
+
+    // 低位选择分片，剩下的位用于分片内的哈希表
+    const size_t hash = std::hash<std::string_view>{}(text);
+    const uint32_t shardIndex = hash & (SHARD_COUNT - 1);
+    const uint32_t shardHash = static_cast<uint32_t>(hash >> SHARD_BITS);
+
+    Shard &shard = shards[shardIndex];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // 保持装载因子不超过 1/2
+    if ((shard.count + 1) * 2 > shard.table.size())
+    {
+        shard.grow();
+    }
+
+    const size_t mask = shard.table.size() - 1;
+
+    for (size_t slot = shardHash & mask;; slot = (slot + 1) & mask)
+    {
+        const uint32_t value = shard.table[slot];
+
+        if (value == 0)
+        {
+            const uint32_t index = shard.count;
+
+            if (index >= MAX_BLOCKS * BLOCK_SIZE)
+            {
+                throw std::length_error("Too many names in the string interner");
+            }
+
+            std::unique_ptr<Entry[]> &block = shard.blocks[index >> BLOCK_BITS];
+
+            if (!block)
+            {
+                block = std::make_unique<Entry[]>(BLOCK_SIZE);
+            }
+
+            block[index & (BLOCK_SIZE - 1)] = {shard.store(text), shardHash};
+            shard.count++;
+            shard.table[slot] = index + 1;
+
+            return NameId(((index + 1) << SHARD_BITS) | shardIndex);
+        }
+
+        const Entry &entry = shard.getEntry(value - 1);
+
+        if (entry.hash == shardHash && entry.text == text)
+        {
+            return NameId((value << SHARD_BITS) | shardIndex);
+        }
+    }
+}
+
+std::string_view StringInterner::lookup(NameId name) const
+{
+    if (name.empty())
+    {
+        return {};
+    }
+
+    const Shard &shard = shards[name.id & (SHARD_COUNT - 1)];
+    return shard.getEntry((name.id >> SHARD_BITS) - 1).text;
+}
+
+size_t StringInterner::size() const
+{
+    size_t result = 0;
+
+    for (const Shard &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        result += shard.count;
+    }
+
+    return result;
+}
+
+std::string_view StringInterner::Shard::store(std::string_view text)
+{
+    // 很长的字符串单独分配，不浪费当前内存块剩下的空间
+    if (text.size() > ARENA_BLOCK_SIZE / 4)
+    {
+        arena.push_back(std::make_unique<char[]>(text.size()));
+        std::memcpy(arena.back().get(), text.data(), text.size());
+        return std::string_view(arena.back().get(), text.size());
+    }
+
+    if (text.size() > arenaLeft)
+    {
+        arena.push_back(std::make_unique<char[]>(ARENA_BLOCK_SIZE));
+        arenaCursor = arena.back().get();
+        arenaLeft = ARENA_BLOCK_SIZE;
+    }
+
+    std::memcpy(arenaCursor, text.data(), text.size());
+    std::string_view result(arenaCursor, text.size());
+
+    arenaCursor += text.size();
+    arenaLeft -= text.size();
+
+    return result;
+}
+
+void StringInterner::Shard::grow()
+{
+    std::vector<uint32_t> newTable(std::max<size_t>(table.size() * 2, 256), 0);
+    const size_t mask = newTable.size() - 1;
+
+    // 使用保存的哈希值重新插入，不需要再次计算字符串的哈希
+    for (uint32_t value : table)
+    {
+        if (value == 0)
+        {
+            continue;
+        }
+
+        size_t slot = getEntry(value - 1).hash & mask;
+
+        while (newTable[slot] != 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+
+        newTable[slot] = value;
+    }
+
+    table = std::move(newTable);
+}
\ No newline at end of file
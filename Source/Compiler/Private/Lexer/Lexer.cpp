@@ -1,508 +1,730 @@
 #include "Lexer/Lexer.hpp"
+#include "Core/StringInterner.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Lexer/Scanner.hpp"
 #include "Logger/Logger.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * CharClass 是字符的分类，Lexer 通过查表得到当前字符的类别后直接分派
+ * 这样可以避免对每一个字符调用 std::isspace/std::isdigit/std::isalpha 并经过一长串 if 判断
+ */
+enum class CharClass : uint8_t
+{
+    OTHER,          // 无法识别的字符
+    NUL,            // '\0' ，可能是源代码结尾的结束标记
+    WHITESPACE,     // 空白字符
+    IDENTIFIER,     // [a-zA-Z_]
+    DIGIT,          // [0-9]
+    DOUBLE_QUOTE,   // "
+    SINGLE_QUOTE,   // '
+    SLASH,          // / ，可能是除号或者注释
+    OPERATOR        // 其它运算符和分隔符
+};
+
+static constexpr std::array<CharClass, 256> buildCharClassTable()
+{
+    std::array<CharClass, 256> table{};
 
-void Lexer::run()
+    table['\0'] = CharClass::NUL;
+
+    for (const unsigned char c : std::string_view{" \t\n\v\f\r"})
+    {
+        table[c] = CharClass::WHITESPACE;
+    }
+
+    for (int c = 'a'; c <= 'z'; c++)
+    {
+        table[c] = CharClass::IDENTIFIER;
+        table[c - 'a' + 'A'] = CharClass::IDENTIFIER;
+    }
+
+    table['_'] = CharClass::IDENTIFIER;
+
+    for (int c = '0'; c <= '9'; c++)
+    {
+        table[c] = CharClass::DIGIT;
+    }
+
+    table['"'] = CharClass::DOUBLE_QUOTE;
+    table['\''] = CharClass::SINGLE_QUOTE;
+    table['/'] = CharClass::SLASH;
+
+    for (const unsigned char c : std::string_view{"+-*<>=!|&{}(),:;."})
+    {
+        table[c] = CharClass::OPERATOR;
+    }
+
+    return table;
+}
+
+// 所有字符的分类表，在编译期生成
+static constexpr std::array<CharClass, 256> charClassTable = buildCharClassTable();
+
+inline CharClass getCharClass(char c)
 {
-    TokenStream &tokens = context->tokenStream;
-    std::string &source = context->fileValue;
+    return charClassTable[static_cast<unsigned char>(c)];
+}
+
+inline bool isIdentifierContinue(char c)
+{
+    CharClass charClass = getCharClass(c);
+    return charClass == CharClass::IDENTIFIER || charClass == CharClass::DIGIT;
+}
+
+/**
+ * 运算符 DFA 的状态，由运算符的第一个字符决定
+ * code 是只有一个字符时的 TokenCode，second/secondCode 描述了可以组成双字符运算符的后继字符
+ * 例如 '=' 可以是 "="，也可以继续转移到 "==" 或 "=>"
+ */
+struct OperatorState
+{
+    TokenCode code = TokenCode::UNDEFINED;
+    std::array<char, 2> second{};
+    std::array<TokenCode, 2> secondCode{TokenCode::UNDEFINED, TokenCode::UNDEFINED};
+};
+
+static constexpr std::array<OperatorState, 256> buildOperatorTable()
+{
+    std::array<OperatorState, 256> table{};
+
+    table['+'] = {TokenCode::PLUS};
+    table['-'] = {TokenCode::MINUS, {'>'}, {TokenCode::ARROW}};
+    table['*'] = {TokenCode::STAR};
+    table['/'] = {TokenCode::SLASH};
+    table['<'] = {TokenCode::LT, {'='}, {TokenCode::LT_EQ}};
+    table['>'] = {TokenCode::GT, {'='}, {TokenCode::GT_EQ}};
+    table['='] = {TokenCode::ASSIGN, {'=', '>'}, {TokenCode::EQ_EQ, TokenCode::DOUBLE_ARROW}};
+    table['!'] = {TokenCode::NOT, {'='}, {TokenCode::NOT_EQ}};
+    table['|'] = {TokenCode::BOR, {'|'}, {TokenCode::OR}};
+    table['&'] = {TokenCode::REFERENCE, {'&'}, {TokenCode::AND}};
+    table[':'] = {TokenCode::COLON, {':'}, {TokenCode::DOUBLE_COLON}};
+    table['{'] = {TokenCode::LBRACE};
+    table['}'] = {TokenCode::RBRACE};
+    table['('] = {TokenCode::LPAREN};
+    table[')'] = {TokenCode::RPAREN};
+    table[','] = {TokenCode::COMMA};
+    table[';'] = {TokenCode::SEMI};
+    table['.'] = {TokenCode::DOT};
+
+    return table;
+}
 
-    while (index < source.size())
+// 所有运算符和分隔符的转移表，在编译期生成
+static constexpr std::array<OperatorState, 256> operatorTable = buildOperatorTable();
+
+/**
+ * 数字字面量 DFA 的状态
+ * [0-9]+ ('.' [0-9]+)? ([eE] [+-]? [0-9]*)?
+ */
+enum NumberState : uint8_t
+{
+    NUMBER_INTEGER,       // 整数部分，可接受为 INT_LITERAL
+    NUMBER_DOT,           // 读到了小数点，还需要一个数字才是浮点数
+    NUMBER_FRACTION,      // 小数部分，可接受为 FLOAT_LITERAL
+    NUMBER_EXPONENT_MARK, // 读到了 'e' 或 'E'，可接受为 FLOAT_LITERAL
+    NUMBER_EXPONENT,      // 指数部分，可接受为 FLOAT_LITERAL
+    NUMBER_DONE,          // 终止状态
+    NUMBER_STATE_COUNT = NUMBER_DONE
+};
+
+// 数字 DFA 的输入字符分类
+enum NumberInput : uint8_t
+{
+    NUMBER_INPUT_DIGIT,
+    NUMBER_INPUT_DOT,
+    NUMBER_INPUT_EXPONENT,
+    NUMBER_INPUT_SIGN,
+    NUMBER_INPUT_OTHER,
+    NUMBER_INPUT_COUNT
+};
+
+static constexpr std::array<NumberInput, 256> buildNumberInputTable()
+{
+    std::array<NumberInput, 256> table{};
+    table.fill(NUMBER_INPUT_OTHER);
+
+    for (int c = '0'; c <= '9'; c++)
+    {
+        table[c] = NUMBER_INPUT_DIGIT;
+    }
+
+    table['.'] = NUMBER_INPUT_DOT;
+    table['e'] = NUMBER_INPUT_EXPONENT;
+    table['E'] = NUMBER_INPUT_EXPONENT;
+    table['+'] = NUMBER_INPUT_SIGN;
+    table['-'] = NUMBER_INPUT_SIGN;
+
+    return table;
+}
+
+static constexpr std::array<NumberInput, 256> numberInputTable = buildNumberInputTable();
+
+// 数字 DFA 的状态转移表：numberTransition[当前状态][输入] = 下一个状态
+static constexpr NumberState numberTransition[NUMBER_STATE_COUNT][NUMBER_INPUT_COUNT] = {
+    /* INTEGER       */ {NUMBER_INTEGER, NUMBER_DOT, NUMBER_EXPONENT_MARK, NUMBER_DONE, NUMBER_DONE},
+    /* DOT           */ {NUMBER_FRACTION, NUMBER_DONE, NUMBER_DONE, NUMBER_DONE, NUMBER_DONE},
+    /* FRACTION      */ {NUMBER_FRACTION, NUMBER_DONE, NUMBER_EXPONENT_MARK, NUMBER_DONE, NUMBER_DONE},
+    /* EXPONENT_MARK */ {NUMBER_EXPONENT, NUMBER_DONE, NUMBER_DONE, NUMBER_EXPONENT, NUMBER_DONE},
+    /* EXPONENT      */ {NUMBER_EXPONENT, NUMBER_DONE, NUMBER_DONE, NUMBER_DONE, NUMBER_DONE},
+};
+
+// 每个状态被接受时对应的 TokenCode ，UNDEFINED 表示不可接受
+static constexpr TokenCode numberAccept[NUMBER_STATE_COUNT] = {
+    TokenCode::INT_LITERAL,
+    TokenCode::UNDEFINED,
+    TokenCode::FLOAT_LITERAL,
+    TokenCode::FLOAT_LITERAL,
+    TokenCode::FLOAT_LITERAL,
+};
+
+// 推测解析失败时抛出的异常
+struct SpeculationFailure
+{
+};
+
+/**
+ * LocalNameTable 记录一个分块中出现的名字，按第一次出现的顺序编号
+ * 分块的 Token 暂时用这个编号作为 nameId ，拼接时再换成驻留后的编号
+ */
+struct LocalNameTable
+{
+    std::vector<std::string_view> names;
+    std::unordered_map<std::string_view, uint32_t> indices;
+
+    uint32_t add(std::string_view text)
     {
-        char current = source[index];
+        const auto [it, inserted] = indices.try_emplace(text, static_cast<uint32_t>(names.size()));
 
-        // 跳过空白字符
-        if (std::isspace(current))
+        if (inserted)
         {
-            skipWhitespace();
-            continue;
+            names.push_back(text);
         }
 
-        // 处理注释
-        if (current == '/' && index + 1 < source.size())
+        return it->second;
+    }
+};
+
+// 并行解析时的一个分块
+struct LexerChunk
+{
+    // 分块的起始位置，总是某一行的开头
+    size_t start = 0;
+    // 起始位置不小于 limit 的 Token 属于下一个分块
+    size_t limit = 0;
+    // 解析停止的位置，也就是下一个分块的第一个 Token 应该开始的位置
+    size_t stop = 0;
+    bool failed = false;
+
+    TokenStream tokens;
+    std::deque<std::string> literalPool;
+    LocalNameTable names;
+};
+
+void Lexer::run()
+{
+    if (cursor == nullptr)
+    {
+        resetCursor();
+    }
+
+    const size_t threadCount = context->options.lexerThreads;
+
+    if (threadCount > 1 && context->fileValue.size() >= context->options.lexerChunkSize * 2)
+    {
+        runParallel(threadCount);
+        return;
+    }
+
+    TokenStream &tokens = context->tokenStream;
+    Token token;
+
+    while (lexNext(token))
+    {
+        tokens.push_back(token);
+    }
+}
+
+void Lexer::runParallel(size_t threadCount)
+{
+    const size_t size = context->fileValue.size();
+    const size_t chunkCount = std::min(threadCount * 4, size / context->options.lexerChunkSize);
+
+    // 在每个分块的理想位置之后找到下一行的开头作为切分点
+    // 切分点可能落在字符串或者块注释里，这种分块的推测解析会在拼接时被发现并重新解析
+    std::vector<LexerChunk> chunks;
+
+    for (size_t i = 0; i < chunkCount; i++)
+    {
+        size_t start = 0;
+
+        if (i != 0)
         {
-            char next = source[index + 1];
-            if (next == '/')
-            {
-                skipLineComment();
-                continue;
-            }
-            if (next == '*')
+            start = Scanner::findByte(begin + size * i / chunkCount, end, '\n') - begin + 1;
+
+            if (start >= size || start <= chunks.back().start)
             {
-                skipBlockComment();
                 continue;
             }
-        }
 
-        // 处理字面量
-        if (current == '"')
-        {
-            tokens.push_back(lexStringLiteral());
-            continue;
-        }
-        if (current == '\'')
-        {
-            tokens.push_back(lexCharLiteral());
-            continue;
-        }
-        if (std::isdigit(current))
-        {
-            tokens.push_back(lexNumber());
-            continue;
+            chunks.back().limit = start;
         }
 
-        // 处理标识符和关键字
-        if (std::isalpha(current) || current == '_')
+        chunks.emplace_back();
+        chunks.back().start = start;
+        chunks.back().limit = size;
+    }
+
+    {
+        ThreadPool threadPool(std::min(threadCount, chunks.size()));
+
+        for (LexerChunk &chunk : chunks)
+        {
+            threadPool.submit([this, &chunk] {
+                Lexer lexer(context);
+                lexer.resetCursor();
+                lexer.cursor = lexer.begin + chunk.start;
+                lexer.literalPool = &chunk.literalPool;
+                lexer.localNames = &chunk.names;
+                lexer.speculative = true;
+
+                try
+                {
+                    chunk.stop = lexer.lexUntil(chunk.limit, chunk.tokens);
+                }
+                catch (const SpeculationFailure &)
+                {
+                    // 错误出现在下一个分块的第一个 Token 上时，这个分块本身的结果仍然有效
+                    chunk.stop = lexer.tokenBegin - lexer.begin;
+                    chunk.failed = chunk.stop < chunk.limit;
+                }
+            });
+        }
+
+        threadPool.wait();
+    }
+
+    // 按顺序拼接，position 是顺序解析时下一个 Token 开始的位置
+    TokenStream &tokens = context->tokenStream;
+    size_t position = 0;
+
+    for (LexerChunk &chunk : chunks)
+    {
+        // 如果分块从 position 开始解析，或者它的第一个 Token 正好在 position 开始，那么之后的结果一定和顺序解析相同
+        const size_t entry = chunk.tokens.empty() ? chunk.stop : chunk.tokens.front().offset;
+
+        if (!chunk.failed && (chunk.start == position || entry == position))
         {
-            tokens.push_back(lexIdentifier());
+            const uint32_t literalBase = context->literalPool.size();
+
+            // 分块中的名字在第一次出现时驻留，驻留的顺序和顺序解析相同
+            std::vector<uint32_t> nameIds(chunk.names.names.size(), 0);
+
+            for (Token token : chunk.tokens)
+            {
+                if (token.code == TokenCode::IDENTIFIER)
+                {
+                    uint32_t &nameId = nameIds[token.nameId];
+
+                    if (nameId == 0)
+                    {
+                        nameId = StringInterner::getInstance().intern(chunk.names.names[token.nameId]).id;
+                    }
+
+                    token.nameId = nameId;
+                }
+                else if (token.hasLiteral())
+                {
+                    token.literalIndex += literalBase;
+                }
+
+                tokens.push_back(token);
+            }
+
+            std::move(chunk.literalPool.begin(), chunk.literalPool.end(), std::back_inserter(context->literalPool));
+            position = chunk.stop;
             continue;
         }
 
-        // 处理运算符和分隔符
-        tokens.push_back(lexOperatorOrDelimiter());
+        // 推测失败，从正确的位置重新顺序解析这个分块，这时的错误会正常输出
+        cursor = begin + position;
+        position = lexUntil(chunk.limit, tokens);
     }
 }
 
-void Lexer::skipWhitespace()
+size_t Lexer::lexUntil(size_t limit, TokenStream &tokens)
 {
-    std::string &source = context->fileValue;
+    Token token;
 
-    while (index < source.size() && std::isspace(source[index]))
+    while (lexNext(token))
     {
-        if (source[index] == '\n')
+        if (token.offset >= limit)
         {
-            line++;
-            lineStart = index + 1;
-            column = 1;
+            // 这个 Token 属于下一个分块，丢弃它保存的字面量
+            if (token.hasLiteral())
+            {
+                literalPool->pop_back();
+            }
+
+            return token.offset;
         }
-        else
+
+        tokens.push_back(token);
+    }
+
+    return end - begin;
+}
+
+void Lexer::resetCursor()
+{
+    begin = context->fileValue.data();
+    cursor = begin;
+    end = begin + context->fileValue.size();
+    literalPool = &context->literalPool;
+}
+
+void Lexer::logError(std::string msg, size_t position)
+{
+    if (speculative)
+    {
+        throw SpeculationFailure{};
+    }
+
+    Logger::Log(Logger::LogLevel::ERROR, {context->fileValue, context->filePath, msg, position, 1, &context->lineTable});
+}
+
+bool Lexer::lexNext(Token &token)
+{
+    if (cursor == nullptr)
+    {
+        resetCursor();
+    }
+
+    // 源代码之后一定有 '\0' ，所以向后多看一个字符不需要检查边界，只有遇到 '\0' 时才判断是否到达结尾
+    for (;;)
+    {
+        switch (getCharClass(*cursor))
         {
-            column++;
+        case CharClass::NUL:
+            if (cursor == end)
+            {
+                return false;
+            }
+
+            // 源代码中间的 '\0' 会作为无法识别的字符报错
+            token = lexOperatorOrDelimiter();
+            return true;
+
+        case CharClass::WHITESPACE:
+            skipWhitespace();
+            break;
+
+        case CharClass::SLASH:
+            // 处理注释
+            if (cursor[1] == '/')
+            {
+                skipLineComment();
+            }
+            else if (cursor[1] == '*')
+            {
+                skipBlockComment();
+            }
+            else
+            {
+                token = lexOperatorOrDelimiter();
+                return true;
+            }
+            break;
+
+        // 处理字面量
+        case CharClass::DOUBLE_QUOTE: token = lexStringLiteral(); return true;
+        case CharClass::SINGLE_QUOTE: token = lexCharLiteral(); return true;
+        case CharClass::DIGIT: token = lexNumber(); return true;
+
+        // 处理标识符和关键字
+        case CharClass::IDENTIFIER: token = lexIdentifier(); return true;
+
+        // 处理运算符和分隔符，无法识别的字符也会在这里报错
+        case CharClass::OPERATOR:
+        case CharClass::OTHER: token = lexOperatorOrDelimiter(); return true;
         }
-        index++;
     }
 }
 
+void Lexer::skipWhitespace()
+{
+    cursor = Scanner::findNonWhitespace(cursor, end);
+}
+
 void Lexer::skipLineComment()
 {
-    std::string &source = context->fileValue;
+    // 跳过 '//' ，直到行尾，行尾的 '\n' 交给 skipWhitespace 处理
+    cursor = Scanner::findByte(cursor + 2, end, '\n');
+}
 
-    // 跳过 '//'
-    index += 2;
-    column += 2;
+void Lexer::skipBlockComment()
+{
+    // 跳过 '/*' 后查找结束标记 '*/'
+    const char *commentEnd = Scanner::findBlockCommentEnd(cursor + 2, end);
 
-    // 跳过直到行尾
-    while (index < source.size() && source[index] != '\n')
+    if (commentEnd == end)
     {
-        index++;
-        column++;
+        // 注释没有闭合，一直到文件结尾都是注释
+        cursor = end;
+        return;
     }
 
-    lineStart = index;
+    cursor = commentEnd + 2;
 }
 
-void Lexer::skipBlockComment()
+Token Lexer::beginToken(TokenCode code)
 {
-    std::string &source = context->fileValue;
+    Token token;
+    token.code = code;
+    token.fileId = context->fileId;
+    token.offset = cursor - begin;
+    tokenBegin = cursor;
+    return token;
+}
 
-    // 跳过 '/*'
-    index += 2;
-    column += 2;
+void Lexer::finishToken(Token &token, const std::string *value)
+{
+    token.length = (cursor - begin) - token.offset;
 
-    while (index < source.size())
+    // 只有转义后的值和源代码中的切片不同时才需要保存
+    if (value != nullptr && *value != context->getTokenValue(token))
     {
-        if (source[index] == '*' && index + 1 < source.size() && source[index + 1] == '/')
-        {
-            // 找到结束标记 '*/'
-            index += 2;
-            column += 2;
-            return;
-        }
-
-        if (source[index] == '\n')
-        {
-            line++;
-            lineStart = index + 1;
-            column = 1;
-        }
-        else
-        {
-            column++;
-        }
-
-        index++;
+        token.literalIndex = literalPool->size();
+        literalPool->push_back(*value);
     }
 }
 
 Token Lexer::lexStringLiteral()
 {
-    std::string &source = context->fileValue;
-
-    Token token;
-    token.code = TokenCode::STRING_LITERAL;
-    token.filePath = context->filePath;
-    token.line = line;
-    token.col = column;
-    token.pos = index;
-    token.lineStart = lineStart;
+    Token token = beginToken(TokenCode::STRING_LITERAL);
 
     // 跳过开头的双引号
-    index++;
-    column++;
+    cursor++;
 
+    // 只有遇到转义字符时才需要构建 value ，没有转义的字符串直接引用源代码
     std::string value;
-    bool escape = false;
+    bool hasEscape = false;
 
-    while (index < source.size())
+    for (;;)
     {
-        char c = source[index];
+        // 一次跳过所有普通字符，只在 '"' 和 '\\' 处停下
+        const char *special = Scanner::findStringSpecial(cursor, end);
 
-        if (c == '\n')
+        if (hasEscape)
         {
-            line++;
-            lineStart = index + 1;
-            column = 1;
+            value.append(cursor, special);
         }
-        else
+
+        cursor = special;
+
+        if (cursor == end)
         {
-            column++;
+            break;
         }
 
-        if (escape)
+        if (*cursor == '"')
         {
-            // 处理转义字符
-            switch (c)
-            {
-            case 'n': value += '\n'; break;
-            case 't': value += '\t'; break;
-            case 'r': value += '\r'; break;
-            case '"': value += '"'; break;
-            case '\\': value += '\\'; break;
-            default:
-                value += '\\';
-                value += c;
-                break;
-            }
-            escape = false;
+            // 结束字符串
+            cursor++;
+            finishToken(token, hasEscape ? &value : nullptr);
+            return token;
         }
-        else if (c == '\\')
+
+        // 处理转义字符
+        if (cursor + 1 == end)
         {
-            escape = true;
+            cursor = end;
+            break;
         }
-        else if (c == '"')
+
+        if (!hasEscape)
         {
-            // 结束字符串
-            index++;
-            token.value = value;
-            return token;
+            hasEscape = true;
+            value.assign(begin + token.offset + 1, cursor);
         }
-        else
+
+        char c = cursor[1];
+        cursor += 2;
+
+        switch (c)
         {
+        case 'n': value += '\n'; break;
+        case 't': value += '\t'; break;
+        case 'r': value += '\r'; break;
+        case '"': value += '"'; break;
+        case '\\': value += '\\'; break;
+        default:
+            value += '\\';
             value += c;
+            break;
         }
-
-        index++;
     }
 
     // 如果到达这里，说明字符串未闭合
-    Logger::Log(Logger::LogLevel::ERROR, {&source, context->filePath, "Unclosed string literal", line, column - 1, 1, lineStart});
+    logError("Unclosed string literal", token.offset);
 
     return token;
 }
 
 Token Lexer::lexCharLiteral()
 {
-    std::string &source = context->fileValue;
-
-    Token token;
-    token.code = TokenCode::CHAR_LITERAL;
-    token.filePath = context->filePath;
-    token.line = line;
-    token.col = column;
-    token.pos = index;
-    token.lineStart = lineStart;
+    Token token = beginToken(TokenCode::CHAR_LITERAL);
 
     // 跳过开头的单引号
-    index++;
-    column++;
+    cursor++;
 
-    if (index >= source.size())
+    if (cursor == end)
     {
-        Logger::Log(Logger::LogLevel::ERROR, {&source, context->filePath, "Unclosed char literal", line, column - 1, 1, lineStart});
+        logError("Unclosed char literal", cursor - begin);
     }
 
-    char c = source[index];
+    std::string value;
+    bool hasEscape = false;
+
+    char c = *cursor;
     if (c == '\\')
     {
         // 处理转义字符
-        index++;
-        column++;
-        if (index >= source.size())
+        cursor++;
+        if (cursor == end)
         {
-            Logger::Log(Logger::LogLevel::ERROR, {&source, context->filePath, "Unclosed char literal", line, column - 1, 1, lineStart});
+            logError("Unclosed char literal", cursor - begin);
         }
 
-        char escape = source[index];
+        hasEscape = true;
+        char escape = *cursor;
         switch (escape)
         {
-        case 'n': token.value = "\n"; break;
-        case 't': token.value = "\t"; break;
-        case 'r': token.value = "\r"; break;
-        case '\'': token.value = "'"; break;
-        case '\\': token.value = "\\"; break;
-        default: token.value = std::string("\\") + escape; break;
+        case 'n': value = "\n"; break;
+        case 't': value = "\t"; break;
+        case 'r': value = "\r"; break;
+        case '\'': value = "'"; break;
+        case '\\': value = "\\"; break;
+        default: value = std::string("\\") + escape; break;
         }
     }
-    else
-    {
-        token.value = std::string(1, c);
-    }
 
-    index++;
-    column++;
+    cursor++;
 
-    // 检查结束单引号
-    if (index >= source.size() || source[index] != '\'')
+    // 检查结束单引号，到达结尾时读到的是 '\0'
+    if (*cursor != '\'')
     {
-        Logger::Log(Logger::LogLevel::ERROR, {&source, context->filePath, "Unclosed char literal", line, column - 1, 1, lineStart});
+        logError("Unclosed char literal", cursor - begin);
     }
 
-    index++;
-    column++;
+    cursor++;
+    finishToken(token, hasEscape ? &value : nullptr);
     return token;
 }
 
 Token Lexer::lexNumber()
 {
-    std::string &source = context->fileValue;
+    Token token = beginToken(TokenCode::UNDEFINED);
 
-    Token token;
-    token.filePath = context->filePath;
-    token.line = line;
-    token.col = column;
-    token.pos = index;
-    token.lineStart = lineStart;
+    // 最长匹配：一直转移到终止状态，记录最后一次可接受的位置
+    // 例如 "1." 后面不是数字时，需要退回到 "1"
+    // 结尾的 '\0' 在任何状态下都会转移到终止状态
+    NumberState state = NUMBER_INTEGER;
+    const char *acceptEnd = cursor + 1;
+    TokenCode acceptCode = TokenCode::INT_LITERAL;
+    const char *p = cursor + 1;
 
-    std::string value;
-    bool isFloat = false;
-    bool hasExponent = false;
-
-    while (index < source.size())
+    for (;;)
     {
-        char c = source[index];
+        state = numberTransition[state][numberInputTable[static_cast<unsigned char>(*p)]];
 
-        if (std::isdigit(c))
+        if (state == NUMBER_DONE)
         {
-            value += c;
-            index++;
-            column++;
-        }
-        else if (c == '.' && !isFloat && !hasExponent)
-        {
-            // 处理浮点数的小数点
-            if (index + 1 < source.size() && std::isdigit(source[index + 1]))
-            {
-                isFloat = true;
-                value += c;
-                index++;
-                column++;
-            }
-            else
-            {
-                // 不是浮点数，可能是成员访问
-                break;
-            }
+            break;
         }
-        else if ((c == 'e' || c == 'E') && !hasExponent)
-        {
-            // 处理指数部分
-            hasExponent = true;
-            value += c;
-            index++;
-            column++;
 
-            // 检查指数符号
-            if (index < source.size() && (source[index] == '+' || source[index] == '-'))
-            {
-                value += source[index];
-                index++;
-                column++;
-            }
-        }
-        else
+        p++;
+
+        if (numberAccept[state] != TokenCode::UNDEFINED)
         {
-            break;
+            acceptEnd = p;
+            acceptCode = numberAccept[state];
         }
     }
 
-    token.code = isFloat || hasExponent ? TokenCode::FLOAT_LITERAL : TokenCode::INT_LITERAL;
-    token.value = value;
+    token.code = acceptCode;
+    cursor = acceptEnd;
+    finishToken(token);
     return token;
 }
 
 Token Lexer::lexIdentifier()
 {
-    std::string &source = context->fileValue;
+    Token token = beginToken(TokenCode::UNDEFINED);
 
-    Token token;
-    token.filePath = context->filePath;
-    token.line = line;
-    token.col = column;
-    token.pos = index;
-    token.lineStart = lineStart;
+    const char *identifierBegin = cursor;
 
-    std::string value;
-    while (index < source.size())
+    // '\0' 不是标识符字符，不需要检查边界
+    while (isIdentifierContinue(*cursor))
     {
-        char c = source[index];
-        if (std::isalnum(c) || c == '_')
-        {
-            value += c;
-            index++;
-            column++;
-        }
-        else
-        {
-            break;
-        }
+        cursor++;
     }
 
+    const std::string_view text(identifierBegin, cursor - identifierBegin);
+
     // 检查是否是关键字
-    if (auto pos = getKeywordPoistion(value); pos)
+    if (auto pos = getKeywordPoistion(text); pos)
     {
         // 将索引转换为TokenCode
         token.code = static_cast<TokenCode>(*pos + static_cast<size_t>(TokenCode::IMPT));
     }
     else
     {
+        // 标识符在这里驻留，之后的阶段只比较编号，并行解析的分块在拼接时才驻留
         token.code = TokenCode::IDENTIFIER;
+        token.nameId = localNames ? localNames->add(text) : StringInterner::getInstance().intern(text).id;
     }
 
-    token.value = value;
+    finishToken(token);
     return token;
 }
 
 Token Lexer::lexOperatorOrDelimiter()
 {
-    std::string &source = context->fileValue;
+    Token token = beginToken(TokenCode::UNDEFINED);
 
-    Token token;
-    token.filePath = context->filePath;
-    token.line = line;
-    token.col = column;
-    token.pos = index;
-    token.lineStart = lineStart;
-
-    char current = source[index];
+    char current = *cursor;
+    const OperatorState &state = operatorTable[static_cast<unsigned char>(current)];
 
-    // 处理双字符运算符
-    if (index + 1 < source.size())
+    if (state.code == TokenCode::UNDEFINED)
     {
-        char next = source[index + 1];
-        std::string twoChars = std::string(1, current) + next;
-
-        if (twoChars == "::")
-        {
-            token.code = TokenCode::DOUBLE_COLON;
-            token.value = twoChars;
-            index += 2;
-            column += 2;
-            return token;
-        }
-        if (twoChars == "==")
-        {
-            token.code = TokenCode::EQ_EQ;
-            token.value = twoChars;
-            index += 2;
-            column += 2;
-            return token;
-        }
-        if (twoChars == "!=")
-        {
-            token.code = TokenCode::NOT_EQ;
-            token.value = twoChars;
-            index += 2;
-            column += 2;
-            return token;
-        }
-        if (twoChars == "<=")
-        {
-            token.code = TokenCode::LT_EQ;
-            token.value = twoChars;
-            index += 2;
-            column += 2;
-            return token;
-        }
-        if (twoChars == ">=")
-        {
-            token.code = TokenCode::GT_EQ;
-            token.value = twoChars;
-            index += 2;
-            column += 2;
-            return token;
-        }
-        if (twoChars == "->")
-        {
-            token.code = TokenCode::ARROW;
-            token.value = twoChars;
-            index += 2;
-            column += 2;
-            return token;
-        }
-        if (twoChars == "=>")
-        {
-            token.code = TokenCode::DOUBLE_ARROW;
-            token.value = twoChars;
-            index += 2;
-            column += 2;
-            return token;
-        }
-        if (twoChars == "||")
-        {
-            token.code = TokenCode::OR;
-            token.value = twoChars;
-            index += 2;
-            column += 2;
-            return token;
-        }
-        if (twoChars == "&&")
-        {
-            token.code = TokenCode::AND;
-            token.value = twoChars;
-            index += 2;
-            column += 2;
-            return token;
-        }
+        logError("Unknown character '" + std::string(1, current) + "'", cursor - begin);
     }
 
-    // 处理单字符运算符和分隔符
-    switch (current)
+    size_t length = 1;
+    token.code = state.code;
+
+    // 处理双字符运算符，当前字符不是结尾，所以下一个字符一定可以读取
+    char next = cursor[1];
+
+    for (size_t i = 0; i < state.second.size(); i++)
     {
-    case '+': token.code = TokenCode::PLUS; break;
-    case '-': token.code = TokenCode::MINUS; break;
-    case '*': token.code = TokenCode::STAR; break;
-    case '/': token.code = TokenCode::SLASH; break;
-    case '<': token.code = TokenCode::LT; break;
-    case '>': token.code = TokenCode::GT; break;
-    case '=': token.code = TokenCode::ASSIGN; break;
-    case '{': token.code = TokenCode::LBRACE; break;
-    case '}': token.code = TokenCode::RBRACE; break;
-    case '(': token.code = TokenCode::LPAREN; break;
-    case ')': token.code = TokenCode::RPAREN; break;
-    case ',': token.code = TokenCode::COMMA; break;
-    case ':': token.code = TokenCode::COLON; break;
-    case ';': token.code = TokenCode::SEMI; break;
-    case '.': token.code = TokenCode::DOT; break;
-    case '&': token.code = TokenCode::REFERENCE; break;
-    case '!': token.code = TokenCode::NOT; break;
-    case '|': token.code = TokenCode::BOR; break;
-    default:
-        Logger::Log(Logger::LogLevel::ERROR, {&source, context->filePath, "Unknown character '" + std::string(1, current) + "'", line, column, 1, lineStart});
+        if (state.secondCode[i] != TokenCode::UNDEFINED && state.second[i] == next)
+        {
+            token.code = state.secondCode[i];
+            length = 2;
+            break;
+        }
     }
 
-    token.value = std::string(1, current);
-    index++;
-    column++;
+    cursor += length;
+    finishToken(token);
     return token;
-}
+}
\ No newline at end of file
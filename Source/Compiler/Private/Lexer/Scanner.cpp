@@ -0,0 +1,340 @@
+#include "Lexer/Scanner.hpp"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LIS_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+/* 标量实现，在不支持 SIMD 的平台上使用，同时负责处理 SIMD 实现剩下的不足一个向量宽度的尾部 */
+
+static inline bool isWhitespaceByte(char c)
+{
+    // '\t' '\n' '\v' '\f' '\r' 是连续的 9 ~ 13
+    return c == ' ' || static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+}
+
+static const char *findNonWhitespaceScalar(const char *begin, const char *end)
+{
+    while (begin < end && isWhitespaceByte(*begin))
+    {
+        begin++;
+    }
+
+    return begin;
+}
+
+static const char *findByteScalar(const char *begin, const char *end, char c)
+{
+    while (begin < end && *begin != c)
+    {
+        begin++;
+    }
+
+    return begin;
+}
+
+static const char *findBlockCommentEndScalar(const char *begin, const char *end)
+{
+    while (begin + 1 < end)
+    {
+        if (begin[0] == '*' && begin[1] == '/')
+        {
+            return begin;
+        }
+
+        begin++;
+    }
+
+    return end;
+}
+
+static const char *findStringSpecialScalar(const char *begin, const char *end)
+{
+    while (begin < end && *begin != '"' && *begin != '\\')
+    {
+        begin++;
+    }
+
+    return begin;
+}
+
+static size_t countNewlinesScalar(const char *begin, const char *end)
+{
+    size_t count = 0;
+
+    for (; begin < end; begin++)
+    {
+        count += *begin == '\n';
+    }
+
+    return count;
+}
+
+#ifdef LIS_SCANNER_X86
+
+/* SSE2 实现，每次处理 16 个字节 */
+
+__attribute__((target("sse2"))) static inline __m128i whitespaceMaskSSE2(__m128i bytes)
+{
+    // (c - '\t') 作为无符号数 <= 4 时就是 '\t' ~ '\r'
+    const __m128i shifted = _mm_sub_epi8(bytes, _mm_set1_epi8('\t'));
+    const __m128i isControl = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8('\r' - '\t')), shifted);
+    return _mm_or_si128(isControl, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')));
+}
+
+__attribute__((target("sse2"))) static const char *findNonWhitespaceSSE2(const char *begin, const char *end)
+{
+    for (; begin + 16 <= end; begin += 16)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+        const unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(whitespaceMaskSSE2(bytes))) & 0xFFFFu;
+
+        if (mask != 0)
+        {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+
+    return findNonWhitespaceScalar(begin, end);
+}
+
+__attribute__((target("sse2"))) static const char *findByteSSE2(const char *begin, const char *end, char c)
+{
+    const __m128i target = _mm_set1_epi8(c);
+
+    for (; begin + 16 <= end; begin += 16)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+        const unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, target));
+
+        if (mask != 0)
+        {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+
+    return findByteScalar(begin, end, c);
+}
+
+__attribute__((target("sse2"))) static const char *findBlockCommentEndSSE2(const char *begin, const char *end)
+{
+    const __m128i star = _mm_set1_epi8('*');
+    const __m128i slash = _mm_set1_epi8('/');
+
+    // 同时加载 begin 和 begin + 1 ，两者对应位置分别是 '*' 和 '/' 时就找到了 "*/"
+    for (; begin + 17 <= end; begin += 16)
+    {
+        const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+        const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin + 1));
+        const unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, star), _mm_cmpeq_epi8(second, slash)));
+
+        if (mask != 0)
+        {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+
+    return findBlockCommentEndScalar(begin, end);
+}
+
+__attribute__((target("sse2"))) static const char *findStringSpecialSSE2(const char *begin, const char *end)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+
+    for (; begin + 16 <= end; begin += 16)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+        const unsigned mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, quote), _mm_cmpeq_epi8(bytes, backslash)));
+
+        if (mask != 0)
+        {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+
+    return findStringSpecialScalar(begin, end);
+}
+
+__attribute__((target("sse2"))) static size_t countNewlinesSSE2(const char *begin, const char *end)
+{
+    const __m128i newline = _mm_set1_epi8('\n');
+    size_t count = 0;
+
+    for (; begin + 16 <= end; begin += 16)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+        count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline)));
+    }
+
+    return count + countNewlinesScalar(begin, end);
+}
+
+/* AVX2 实现，每次处理 32 个字节 */
+
+__attribute__((target("avx2"))) static inline __m256i whitespaceMaskAVX2(__m256i bytes)
+{
+    const __m256i shifted = _mm256_sub_epi8(bytes, _mm256_set1_epi8('\t'));
+    const __m256i isControl = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8('\r' - '\t')), shifted);
+    return _mm256_or_si256(isControl, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')));
+}
+
+__attribute__((target("avx2"))) static const char *findNonWhitespaceAVX2(const char *begin, const char *end)
+{
+    for (; begin + 32 <= end; begin += 32)
+    {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+        const unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(whitespaceMaskAVX2(bytes)));
+
+        if (mask != 0)
+        {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+
+    return findNonWhitespaceSSE2(begin, end);
+}
+
+__attribute__((target("avx2"))) static const char *findByteAVX2(const char *begin, const char *end, char c)
+{
+    const __m256i target = _mm256_set1_epi8(c);
+
+    for (; begin + 32 <= end; begin += 32)
+    {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+        const unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, target));
+
+        if (mask != 0)
+        {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+
+    return findByteSSE2(begin, end, c);
+}
+
+__attribute__((target("avx2"))) static const char *findBlockCommentEndAVX2(const char *begin, const char *end)
+{
+    const __m256i star = _mm256_set1_epi8('*');
+    const __m256i slash = _mm256_set1_epi8('/');
+
+    for (; begin + 33 <= end; begin += 32)
+    {
+        const __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+        const __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin + 1));
+        const unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, star), _mm256_cmpeq_epi8(second, slash)));
+
+        if (mask != 0)
+        {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+
+    return findBlockCommentEndSSE2(begin, end);
+}
+
+__attribute__((target("avx2"))) static const char *findStringSpecialAVX2(const char *begin, const char *end)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+
+    for (; begin + 32 <= end; begin += 32)
+    {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+        const unsigned mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, quote), _mm256_cmpeq_epi8(bytes, backslash)));
+
+        if (mask != 0)
+        {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+
+    return findStringSpecialSSE2(begin, end);
+}
+
+__attribute__((target("avx2,popcnt"))) static size_t countNewlinesAVX2(const char *begin, const char *end)
+{
+    const __m256i newline = _mm256_set1_epi8('\n');
+    size_t count = 0;
+
+    for (; begin + 32 <= end; begin += 32)
+    {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+        count += __builtin_popcount(static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newline))));
+    }
+
+    return count + countNewlinesSSE2(begin, end);
+}
+
+#endif
+
+/**
+ * ScannerImplementation 描述了一组扫描函数的实现
+ */
+struct ScannerImplementation
+{
+    const char *name;
+    const char *(*findNonWhitespace)(const char *, const char *);
+    const char *(*findByte)(const char *, const char *, char);
+    const char *(*findBlockCommentEnd)(const char *, const char *);
+    const char *(*findStringSpecial)(const char *, const char *);
+    size_t (*countNewlines)(const char *, const char *);
+};
+
+static ScannerImplementation selectImplementation()
+{
+#ifdef LIS_SCANNER_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+    {
+        return {"avx2", findNonWhitespaceAVX2, findByteAVX2, findBlockCommentEndAVX2, findStringSpecialAVX2, countNewlinesAVX2};
+    }
+
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return {"sse2", findNonWhitespaceSSE2, findByteSSE2, findBlockCommentEndSSE2, findStringSpecialSSE2, countNewlinesSSE2};
+    }
+#endif
+
+    return {"scalar", findNonWhitespaceScalar, findByteScalar, findBlockCommentEndScalar, findStringSpecialScalar, countNewlinesScalar};
+}
+
+static const ScannerImplementation &getImplementation()
+{
+    // 局部静态变量只会在第一次调用时初始化，并且初始化是线程安全的
+    static const ScannerImplementation implementation = selectImplementation();
+    return implementation;
+}
+
+const char *Scanner::findNonWhitespace(const char *begin, const char *end)
+{
+    return getImplementation().findNonWhitespace(begin, end);
+}
+
+const char *Scanner::findByte(const char *begin, const char *end, char c)
+{
+    return getImplementation().findByte(begin, end, c);
+}
+
+const char *Scanner::findBlockCommentEnd(const char *begin, const char *end)
+{
+    return getImplementation().findBlockCommentEnd(begin, end);
+}
+
+const char *Scanner::findStringSpecial(const char *begin, const char *end)
+{
+    return getImplementation().findStringSpecial(begin, end);
+}
+
+size_t Scanner::countNewlines(const char *begin, const char *end)
+{
+    return getImplementation().countNewlines(begin, end);
+}
+
+const char *Scanner::getImplementationName()
+{
+    return getImplementation().name;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "Lexer/TokenCursor.hpp"
+
+#include <stdexcept>
+
+const Token *TokenCursor::peek(size_t ahead)
+{
+    const size_t index = position + ahead;
+
+    if (stream != nullptr)
+    {
+        return index < stream->size() ? &(*stream)[index] : nullptr;
+    }
+
+    // 向前看的距离必须小于缓冲区大小，否则当前 Token 会被覆盖
+    if (ahead >= RING_SIZE - 1)
+    {
+        throw std::logic_error("TokenCursor lookahead exceeds the ring buffer");
+    }
+
+    while (produced <= index && !exhausted)
+    {
+        if (lexer->lexNext(ring[produced & (RING_SIZE - 1)]))
+        {
+            produced++;
+        }
+        else
+        {
+            exhausted = true;
+        }
+    }
+
+    return index < produced ? &ring[index & (RING_SIZE - 1)] : nullptr;
+}
+
+const Token &TokenCursor::previous() const
+{
+    if (stream != nullptr)
+    {
+        return stream->at(position - 1);
+    }
+
+    if (position == 0 || !isBuffered(position - 1))
+    {
+        throw std::logic_error("TokenCursor has no previous token");
+    }
+
+    return ring[(position - 1) & (RING_SIZE - 1)];
+}
+
+void TokenCursor::rewind(size_t target)
+{
+    if (stream == nullptr && target < position && !isBuffered(target))
+    {
+        throw std::logic_error("TokenCursor cannot rewind past the ring buffer");
+    }
+
+    position = target;
+}
\ No newline at end of file
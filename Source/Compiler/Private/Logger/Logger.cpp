@@ -3,33 +3,33 @@
 #include <cmath>
 #include <iostream>
 
-void LogCode(Logger::LogInfo &info, std::string color)
+void LogCode(Logger::LogInfo &info, const SourceLocation &location, std::string color)
 {
-    const int lineLength = std::log10(info.line) + 1;
+    const int lineLength = std::log10(location.line) + 1;
 
     std::string codeStr = "";
     std::string errStr = "";
 
     for (int i = 0; i <= i + 15; i++)
     {
-        if (info.beginPosition + i >= info.code->size())
+        if (location.lineStart + i >= info.code.size())
         {
             break;
         }
 
-        char code = info.code->at(info.beginPosition + i);
+        char code = info.code[location.lineStart + i];
 
         if (code == '\t' || code == '\n')
         {
             break;
         }
 
-        if (i == info.col - 1)
+        if (i == location.col - 1)
         {
             codeStr.append(color);
         }
 
-        if (i == info.col - 1 + info.length)
+        if (i == location.col - 1 + info.length)
         {
             codeStr.append("\033[0m");
         }
@@ -42,22 +42,21 @@ void LogCode(Logger::LogInfo &info, std::string color)
 
     codeStr.append("\033[0m");
 
-    printf("    %d | %s\n", info.line, codeStr.c_str());
+    printf("    %zu | %s\n", location.line, codeStr.c_str());
 
-    if (info.col == 1)
+    if (location.col == 1)
     {
-        printf("%*s| ^", lineLength + 5, " ");
+        printf("%*s| ^\n", lineLength + 5, " ");
     }
     else
     {
-        printf("%*s| %*s%s^%s\033[0m\n", lineLength + 5, " ", info.col - 1, " ", color.c_str(), errStr.c_str());
+        printf("%*s| %*s%s^%s\033[0m\n", lineLength + 5, " ", static_cast<int>(location.col - 1), " ", color.c_str(), errStr.c_str());
     }
 }
 
-void Logger::Log(Logger::LogLevel level, Logger::LogInfo info)
+// 输出信息的级别，返回标记出错代码使用的颜色
+std::string LogLevelName(Logger::LogLevel level)
 {
-    printf("\033[1m%s:%d:%d:\033[0m", info.codePath.c_str(), info.line, info.col);
-
     std::string color = "";
 
     switch (level)
@@ -78,11 +77,13 @@ void Logger::Log(Logger::LogLevel level, Logger::LogInfo info)
         break;
     }
 
-    printf((info.msg + "\n").c_str());
-
-    LogCode(info, color);
+    return color;
+}
 
-    if (level == LogLevel::ERROR)
+// 错误会终止编译
+void LogFinish(Logger::LogLevel level)
+{
+    if (level == Logger::LogLevel::ERROR)
     {
 #ifdef __DEBUG__
         throw std::runtime_error("Create debug point");
@@ -90,4 +91,35 @@ void Logger::Log(Logger::LogLevel level, Logger::LogInfo info)
         exit(1);
 #endif
     }
+}
+
+void Logger::Log(Logger::LogLevel level, Logger::LogInfo info)
+{
+    Print(level, info);
+
+    LogFinish(level);
+}
+
+void Logger::Print(Logger::LogLevel level, Logger::LogInfo info)
+{
+    const SourceLocation location = info.lineTable->getLocation(info.code, info.position);
+
+    printf("\033[1m%s:%zu:%zu:\033[0m", info.codePath.c_str(), location.line, location.col);
+
+    std::string color = LogLevelName(level);
+
+    printf((info.msg + "\n").c_str());
+
+    LogCode(info, location, color);
+}
+
+void Logger::Log(Logger::LogLevel level, std::string codePath, std::string msg)
+{
+    printf("\033[1m%s:\033[0m", codePath.c_str());
+
+    LogLevelName(level);
+
+    printf((msg + "\n").c_str());
+
+    LogFinish(level);
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "Parser/ASTContext.hpp"
+
+#include <cstdint>
+#include <iterator>
+
+void *ASTContext::allocate(size_t size, size_t alignment)
+{
+    allocatedBytes += size;
+
+    // 大的分配单独占用一块内存，不浪费当前块的剩余空间，cursor 仍然指向原来的块
+    if (size > BLOCK_SIZE / 4)
+    {
+        blocks.push_back(std::make_unique_for_overwrite<std::byte[]>(size + alignment));
+
+        const uintptr_t address = reinterpret_cast<uintptr_t>(blocks.back().get());
+        return reinterpret_cast<void *>((address + alignment - 1) & ~(uintptr_t)(alignment - 1));
+    }
+
+    uintptr_t address = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+    if (cursor == nullptr || address + size > reinterpret_cast<uintptr_t>(limit))
+    {
+        blocks.push_back(std::make_unique_for_overwrite<std::byte[]>(BLOCK_SIZE));
+        cursor = blocks.back().get();
+        limit = cursor + BLOCK_SIZE;
+
+        address = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    }
+
+    cursor = reinterpret_cast<std::byte *>(address + size);
+    return reinterpret_cast<void *>(address);
+}
+
+void ASTContext::adopt(ASTContext &&other)
+{
+    // cursor 仍然指向原来的块，新加入的块不会再用于分配
+    blocks.insert(blocks.end(), std::make_move_iterator(other.blocks.begin()), std::make_move_iterator(other.blocks.end()));
+    allocatedBytes += other.allocatedBytes;
+
+    other.reset();
+}
+
+void ASTContext::reset()
+{
+    blocks.clear();
+    cursor = nullptr;
+    limit = nullptr;
+    allocatedBytes = 0;
+}
\ No newline at end of file
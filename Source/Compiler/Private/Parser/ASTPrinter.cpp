@@ -2,36 +2,15 @@
  * Copyright 2025, LiserverYang. All rights reserved.
  */
 
-#include <cxxabi.h>
 #include <iomanip>
 #include <iostream>
 #include <memory>
 #include <sstream>
-#include <typeinfo>
 #include <vector>
 
+#include "Core/Context.hpp"
 #include "Parser/AST.hpp"
 
-// 辅助函数：获取可读的类型名
-std::string demangle(const char *mangled)
-{
-    int status;
-    char *demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
-    if (status == 0)
-    {
-        std::string result(demangled);
-        free(demangled);
-        // 移除命名空间
-        size_t pos = result.find_last_of(':');
-        if (pos != std::string::npos)
-        {
-            return result.substr(pos + 1);
-        }
-        return result;
-    }
-    return mangled;
-}
-
 // 辅助函数：格式化指针地址
 std::string formatAddress(const void *addr)
 {
@@ -41,7 +20,7 @@ std::string formatAddress(const void *addr)
     return ss.str();
 }
 
-void printAST(const ASTNode *node, const std::string &prefix = "", bool isLast = true);
+void printAST(const ASTNode *node, const std::string &prefix = "", bool isLast = true, Context *context = nullptr);
 
 // 处理类型节点
 void printTypeInfo(const Type *type, std::ostream &os)
@@ -79,7 +58,7 @@ void printTypeInfo(const Type *type, std::ostream &os)
 }
 
 // 处理各种AST节点
-void printNodeInfo(const ASTNode *node, std::ostream &os)
+void printNodeInfo(const ASTNode *node, std::ostream &os, Context *context)
 {
     if (!node)
     {
@@ -87,18 +66,29 @@ void printNodeInfo(const ASTNode *node, std::ostream &os)
         return;
     }
 
-    std::string nodeType = demangle(typeid(*node).name());
+    std::string_view nodeType = getKindName(node->getKind());
     std::string address = formatAddress(node);
 
     os << "\033[38;5;10m" << nodeType << "\033[0m" << " " << "\033[38;5;3m" << address << "\033[0m";
 
+    // 行列信息只在需要时通过行首表计算
+    if (context)
+    {
+        SourceLocation location = context->getLocation(node->offset);
+        os << " \033[38;5;3m<" << location.line << ":" << location.col << ">\033[0m";
+    }
+
     // 根据节点类型添加附加信息
-    if (auto p = dynamic_cast<const Program *>(node))
+    switch (node->getKind())
+    {
+    case ASTKind::Program:
     {
         os << " [Program]";
+        break;
     }
-    else if (auto m = dynamic_cast<const ModulePath *>(node))
+    case ASTKind::ModulePath:
     {
+        auto m = cast<ModulePath>(node);
         os << " path: \033[38;5;2m'";
         for (size_t i = 0; i < m->pathSegments.size(); ++i)
         {
@@ -107,14 +97,18 @@ void printNodeInfo(const ASTNode *node, std::ostream &os)
             os << m->pathSegments[i];
         }
         os << "'\033[0m";
+        break;
     }
-    else if (auto t = dynamic_cast<const Type *>(node))
+    case ASTKind::Type:
     {
+        auto t = cast<Type>(node);
         os << " ";
         printTypeInfo(t, os);
+        break;
     }
-    else if (auto imp = dynamic_cast<const ImportStmt *>(node))
+    case ASTKind::ImportStmt:
     {
+        auto imp = cast<ImportStmt>(node);
         os << " import: \033[38;5;2m'";
         if (imp->modulePath)
         {
@@ -133,109 +127,150 @@ void printNodeInfo(const ASTNode *node, std::ostream &os)
             }
             os << "]\033[0m";
         }
-        if (imp->alias)
+        if (!imp->alias.empty())
         {
-            os << " alias: \033[38;5;2m" << *imp->alias << "\033[0m";
+            os << " alias: \033[38;5;2m" << imp->alias << "\033[0m";
         }
+        break;
     }
-    else if (auto mv = dynamic_cast<const MemberVarDef *>(node))
+    case ASTKind::MemberVarDef:
     {
+        auto mv = cast<MemberVarDef>(node);
         os << " " << "\033[38;5;14m" << (mv->isPublic ? "public " : "private ") << "\033[0m"
            << "\033[38;5;2m" << mv->name << "\033[0m" << ": ";
-        printTypeInfo(mv->type.get(), os);
+        printTypeInfo(mv->type, os);
+        break;
     }
-    else if (auto sd = dynamic_cast<const StructDef *>(node))
+    case ASTKind::StructDef:
     {
+        auto sd = cast<StructDef>(node);
         os << " struct \033[38;5;2m" << sd->name << "\033[0m";
+        break;
     }
-    else if (auto p = dynamic_cast<const Param *>(node))
+    case ASTKind::Param:
     {
+        auto p = cast<Param>(node);
         os << " " << p->name << ": ";
-        if (p->type && *p->type)
+        if (p->type)
         {
-            printTypeInfo(p->type->get(), os);
+            printTypeInfo(p->type, os);
         }
         else
         {
             os << "<inferred>";
         }
+        break;
     }
-    else if (auto sp = dynamic_cast<const SelfParam *>(node))
+    case ASTKind::SelfParam:
     {
+        auto sp = cast<SelfParam>(node);
         os << " self: " << (sp->isRef ? "ref " : "")
            << (sp->isMut ? "mut " : "");
-        if (sp->type && *sp->type)
+        if (sp->type)
         {
-            printTypeInfo(sp->type->get(), os);
+            printTypeInfo(sp->type, os);
         }
+        break;
     }
-    else if (auto mf = dynamic_cast<const MemberFunctionDef *>(node))
+    case ASTKind::MemberFunctionDef:
     {
+        auto mf = cast<MemberFunctionDef>(node);
         os << " fn " << mf->name << "()";
+        if (mf->hasPendingBody())
+        {
+            os << " [lazy body]";
+        }
+        break;
     }
-    else if (auto si = dynamic_cast<const StructImpl *>(node))
+    case ASTKind::StructImpl:
     {
+        auto si = cast<StructImpl>(node);
         os << " impl " << si->structName;
+        break;
     }
-    else if (auto fd = dynamic_cast<const FunctionDef *>(node))
+    case ASTKind::FunctionDef:
     {
+        auto fd = cast<FunctionDef>(node);
         os << " fn " << fd->name << "()";
+        if (fd->hasPendingBody())
+        {
+            os << " [lazy body]";
+        }
+        break;
     }
-    else if (auto gv = dynamic_cast<const GlobalVarDef *>(node))
+    case ASTKind::GlobalVarDef:
     {
+        auto gv = cast<GlobalVarDef>(node);
         os << " " << (gv->isMove ? "move " : "") << gv->name << ": ";
-        if (gv->type && *gv->type)
+        if (gv->type)
         {
-            printTypeInfo(gv->type->get(), os);
+            printTypeInfo(gv->type, os);
         }
         else
         {
             os << "<inferred>";
         }
+        break;
     }
-    else if (auto cs = dynamic_cast<const CompoundStmt *>(node))
+    case ASTKind::CompoundStmt:
     {
         os << " [CompoundStmt]";
+        break;
     }
-    else if (auto is = dynamic_cast<const IfStmt *>(node))
+    case ASTKind::IfStmt:
     {
         os << " [IfStmt]";
+        break;
     }
-    else if (auto rs = dynamic_cast<const ReturnStmt *>(node))
+    case ASTKind::ReturnStmt:
     {
         os << " [ReturnStmt]";
+        break;
     }
-    else if (auto ds = dynamic_cast<const DeclStmt *>(node))
+    case ASTKind::DeclStmt:
     {
+        auto ds = cast<DeclStmt>(node);
         os << " " << (ds->isMutable ? "mut " : "") << ds->name << ": ";
-        if (ds->type && *ds->type)
+        if (ds->type)
         {
-            printTypeInfo(ds->type->get(), os);
+            printTypeInfo(ds->type, os);
         }
         else
         {
             os << "<inferred>";
         }
+        break;
     }
-    else if (auto as = dynamic_cast<const AssignStmt *>(node))
+    case ASTKind::AssignStmt:
     {
         os << " [AssignStmt]";
+        break;
     }
-    else if (auto es = dynamic_cast<const ExprStmt *>(node))
+    case ASTKind::ExprStmt:
     {
         os << " [ExprStmt]";
+        break;
     }
-    else if (auto fs = dynamic_cast<const ForStmt *>(node))
+    case ASTKind::ForStmt:
     {
+        auto fs = cast<ForStmt>(node);
         os << " for " << fs->loopVar;
+        break;
     }
-    else if (auto ws = dynamic_cast<const WhileStmt *>(node))
+    case ASTKind::WhileStmt:
     {
         os << " [WhileStmt]";
+        break;
+    }
+    case ASTKind::ErrorStmt:
+    {
+        os << " [ErrorStmt]";
+        break;
     }
-    else if (auto lit = dynamic_cast<const LiteralExpr *>(node))
+    case ASTKind::LiteralExpr:
     {
-        os << " literal: " << lit->value << " (";
+        auto lit = cast<LiteralExpr>(node);
+        os << " literal: " << (context ? context->getLiteralValue(*lit) : "?") << " (";
         switch (lit->type)
         {
         case LiteralExpr::LiteralType::Int: os << "int"; break;
@@ -245,13 +280,17 @@ void printNodeInfo(const ASTNode *node, std::ostream &os)
         case LiteralExpr::LiteralType::Char: os << "char"; break;
         }
         os << ")";
+        break;
     }
-    else if (auto id = dynamic_cast<const IdentifierExpr *>(node))
+    case ASTKind::IdentifierExpr:
     {
+        auto id = cast<IdentifierExpr>(node);
         os << " identifier: " << id->name;
+        break;
     }
-    else if (auto mid = dynamic_cast<const ModuleIdentifierExpr *>(node))
+    case ASTKind::ModuleIdentifierExpr:
     {
+        auto mid = cast<ModuleIdentifierExpr>(node);
         os << " module_id: ";
         if (mid->modulePath)
         {
@@ -261,40 +300,63 @@ void printNodeInfo(const ASTNode *node, std::ostream &os)
             }
         }
         os << mid->name;
+        break;
     }
-    else if (auto si = dynamic_cast<const StructInitExpr *>(node))
+    case ASTKind::StructInitExpr:
     {
+        auto si = cast<StructInitExpr>(node);
         os << " struct_init: ";
-        printTypeInfo(si->structType.get(), os);
+        printTypeInfo(si->structType, os);
+        break;
     }
-    else if (auto smc = dynamic_cast<const StaticMemberCall *>(node))
+    case ASTKind::StaticMemberCall:
     {
+        auto smc = cast<StaticMemberCall>(node);
         os << " static_call: " << smc->methodName;
+        break;
     }
-    else if (auto mfc = dynamic_cast<const MemberFunctionCall *>(node))
+    case ASTKind::MemberFunctionCall:
     {
+        auto mfc = cast<MemberFunctionCall>(node);
         os << " method_call: " << mfc->methodName;
+        break;
     }
-    else if (auto fc = dynamic_cast<const FunctionCall *>(node))
+    case ASTKind::FunctionCall:
     {
         os << " function_call";
+        break;
     }
-    else if (auto ma = dynamic_cast<const MemberAccess *>(node))
+    case ASTKind::MemberAccess:
     {
+        auto ma = cast<MemberAccess>(node);
         os << " member_access: " << ma->memberName;
+        break;
     }
-    else if (auto bin = dynamic_cast<const BinaryOp *>(node))
+    case ASTKind::BinaryOp:
     {
+        auto bin = cast<BinaryOp>(node);
         os << " binary_op: " << bin->op;
+        break;
     }
-    else if (auto cast = dynamic_cast<const CastExpr *>(node))
+    case ASTKind::UnaryOp:
     {
+        auto unary = cast<UnaryOp>(node);
+        os << " unary_op: " << getUnaryOpSpelling(unary->op);
+        break;
+    }
+    case ASTKind::CastExpr:
+    {
+        auto castExpr = cast<CastExpr>(node);
         os << " cast: ";
-        printTypeInfo(cast->targetType.get(), os);
+        printTypeInfo(castExpr->targetType, os);
+        break;
     }
-    else if (auto paren = dynamic_cast<const ParenExpr *>(node))
+    case ASTKind::ParenExpr:
     {
         os << " [ParenExpr]";
+        break;
+    }
+    default: break;
     }
 }
 
@@ -306,211 +368,270 @@ std::vector<const ASTNode *> getChildren(const ASTNode *node)
     if (!node)
         return children;
 
-    if (auto p = dynamic_cast<const Program *>(node))
+    switch (node->getKind())
+    {
+    case ASTKind::Program:
     {
+        auto p = cast<Program>(node);
         for (const auto &stmt : p->globalStatements)
         {
-            children.push_back(stmt.get());
+            children.push_back(stmt);
         }
+        break;
     }
-    else if (auto t = dynamic_cast<const Type *>(node))
+    case ASTKind::Type:
     {
+        auto t = cast<Type>(node);
         if (t->modulePath)
         {
-            children.push_back(t->modulePath.get());
+            children.push_back(t->modulePath);
         }
+        break;
     }
-    else if (auto imp = dynamic_cast<const ImportStmt *>(node))
+    case ASTKind::ImportStmt:
     {
+        auto imp = cast<ImportStmt>(node);
         if (imp->modulePath)
         {
-            children.push_back(imp->modulePath.get());
+            children.push_back(imp->modulePath);
         }
+        break;
     }
-    else if (auto sd = dynamic_cast<const StructDef *>(node))
+    case ASTKind::StructDef:
     {
+        auto sd = cast<StructDef>(node);
         for (const auto &member : sd->members)
         {
-            children.push_back(member.get());
+            children.push_back(member);
         }
+        break;
     }
-    else if (auto mf = dynamic_cast<const MemberFunctionDef *>(node))
+    case ASTKind::MemberFunctionDef:
     {
-        if (mf->selfParam && *mf->selfParam)
+        auto mf = cast<MemberFunctionDef>(node);
+        if (mf->selfParam)
         {
-            children.push_back(mf->selfParam->get());
+            children.push_back(mf->selfParam);
         }
         for (const auto &param : mf->params)
         {
-            children.push_back(param.get());
+            children.push_back(param);
         }
-        if (mf->returnType && *mf->returnType)
+        if (mf->returnType)
         {
-            children.push_back(mf->returnType->get());
+            children.push_back(mf->returnType);
         }
         if (mf->body)
         {
-            children.push_back(mf->body.get());
+            children.push_back(mf->body);
         }
+        break;
     }
-    else if (auto si = dynamic_cast<const StructImpl *>(node))
+    case ASTKind::StructImpl:
     {
+        auto si = cast<StructImpl>(node);
         for (const auto &method : si->methods)
         {
-            children.push_back(method.get());
+            children.push_back(method);
         }
+        break;
     }
-    else if (auto fd = dynamic_cast<const FunctionDef *>(node))
+    case ASTKind::FunctionDef:
     {
+        auto fd = cast<FunctionDef>(node);
         for (const auto &param : fd->params)
         {
-            children.push_back(param.get());
+            children.push_back(param);
         }
-        if (fd->returnType && *fd->returnType)
+        if (fd->returnType)
         {
-            children.push_back(fd->returnType->get());
+            children.push_back(fd->returnType);
         }
         if (fd->body)
         {
-            children.push_back(fd->body.get());
+            children.push_back(fd->body);
         }
+        break;
     }
-    else if (auto gv = dynamic_cast<const GlobalVarDef *>(node))
+    case ASTKind::GlobalVarDef:
     {
-        if (gv->type && *gv->type)
+        auto gv = cast<GlobalVarDef>(node);
+        if (gv->type)
         {
-            children.push_back(gv->type->get());
+            children.push_back(gv->type);
         }
         if (gv->initValue)
         {
-            children.push_back(gv->initValue.get());
+            children.push_back(gv->initValue);
         }
+        break;
     }
-    else if (auto cs = dynamic_cast<const CompoundStmt *>(node))
+    case ASTKind::CompoundStmt:
     {
+        auto cs = cast<CompoundStmt>(node);
         for (const auto &stmt : cs->statements)
         {
-            children.push_back(stmt.get());
+            children.push_back(stmt);
         }
+        break;
     }
-    else if (auto is = dynamic_cast<const IfStmt *>(node))
+    case ASTKind::IfStmt:
     {
+        auto is = cast<IfStmt>(node);
         if (is->condition)
-            children.push_back(is->condition.get());
+            children.push_back(is->condition);
         if (is->thenBranch)
-            children.push_back(is->thenBranch.get());
-        if (is->elseBranch && *is->elseBranch)
+            children.push_back(is->thenBranch);
+        if (is->elseBranch)
         {
-            children.push_back(is->elseBranch->get());
+            children.push_back(is->elseBranch);
         }
+        break;
     }
-    else if (auto rs = dynamic_cast<const ReturnStmt *>(node))
+    case ASTKind::ReturnStmt:
     {
-        if (rs->returnValue && *rs->returnValue)
+        auto rs = cast<ReturnStmt>(node);
+        if (rs->returnValue)
         {
-            children.push_back(rs->returnValue->get());
+            children.push_back(rs->returnValue);
         }
+        break;
     }
-    else if (auto ds = dynamic_cast<const DeclStmt *>(node))
+    case ASTKind::DeclStmt:
     {
-        if (ds->type && *ds->type)
+        auto ds = cast<DeclStmt>(node);
+        if (ds->type)
         {
-            children.push_back(ds->type->get());
+            children.push_back(ds->type);
         }
-        if (ds->initValue && ds->initValue.value())
+        if (ds->initValue)
         {
-            children.push_back(ds->initValue.value().get());
+            children.push_back(ds->initValue);
         }
+        break;
     }
-    else if (auto as = dynamic_cast<const AssignStmt *>(node))
+    case ASTKind::AssignStmt:
     {
+        auto as = cast<AssignStmt>(node);
         if (as->target)
-            children.push_back(as->target.get());
+            children.push_back(as->target);
         if (as->value)
-            children.push_back(as->value.get());
+            children.push_back(as->value);
+        break;
     }
-    else if (auto es = dynamic_cast<const ExprStmt *>(node))
+    case ASTKind::ExprStmt:
     {
+        auto es = cast<ExprStmt>(node);
         if (es->expression)
-            children.push_back(es->expression.get());
+            children.push_back(es->expression);
+        break;
     }
-    else if (auto fs = dynamic_cast<const ForStmt *>(node))
+    case ASTKind::ForStmt:
     {
+        auto fs = cast<ForStmt>(node);
         if (fs->iterable)
-            children.push_back(fs->iterable.get());
+            children.push_back(fs->iterable);
         if (fs->body)
-            children.push_back(fs->body.get());
+            children.push_back(fs->body);
+        break;
     }
-    else if (auto ws = dynamic_cast<const WhileStmt *>(node))
+    case ASTKind::WhileStmt:
     {
+        auto ws = cast<WhileStmt>(node);
         if (ws->condition)
-            children.push_back(ws->condition.get());
+            children.push_back(ws->condition);
         if (ws->body)
-            children.push_back(ws->body.get());
+            children.push_back(ws->body);
+        break;
     }
-    else if (auto si = dynamic_cast<const StructInitExpr *>(node))
+    case ASTKind::StructInitExpr:
     {
-        children.push_back(si->structType.get());
-        for (const auto &[name, expr] : si->memberInits)
+        auto si = cast<StructInitExpr>(node);
+        children.push_back(si->structType);
+        for (const MemberInit &init : si->memberInits)
         {
-            children.push_back(expr.get());
+            children.push_back(init.value);
         }
+        break;
     }
-    else if (auto smc = dynamic_cast<const StaticMemberCall *>(node))
+    case ASTKind::StaticMemberCall:
     {
-        children.push_back(smc->classType.get());
+        auto smc = cast<StaticMemberCall>(node);
+        children.push_back(smc->classType);
         for (const auto &arg : smc->arguments)
         {
-            children.push_back(arg.get());
+            children.push_back(arg);
         }
+        break;
     }
-    else if (auto mfc = dynamic_cast<const MemberFunctionCall *>(node))
+    case ASTKind::MemberFunctionCall:
     {
+        auto mfc = cast<MemberFunctionCall>(node);
         if (mfc->object)
-            children.push_back(mfc->object.get());
+            children.push_back(mfc->object);
         for (const auto &arg : mfc->arguments)
         {
-            children.push_back(arg.get());
+            children.push_back(arg);
         }
+        break;
     }
-    else if (auto fc = dynamic_cast<const FunctionCall *>(node))
+    case ASTKind::FunctionCall:
     {
+        auto fc = cast<FunctionCall>(node);
         if (fc->function)
-            children.push_back(fc->function.get());
+            children.push_back(fc->function);
         for (const auto &arg : fc->arguments)
         {
-            children.push_back(arg.get());
+            children.push_back(arg);
         }
+        break;
     }
-    else if (auto ma = dynamic_cast<const MemberAccess *>(node))
+    case ASTKind::MemberAccess:
     {
+        auto ma = cast<MemberAccess>(node);
         if (ma->object)
-            children.push_back(ma->object.get());
+            children.push_back(ma->object);
+        break;
     }
-    else if (auto bin = dynamic_cast<const BinaryOp *>(node))
+    case ASTKind::BinaryOp:
     {
+        auto bin = cast<BinaryOp>(node);
         if (bin->left)
-            children.push_back(bin->left.get());
+            children.push_back(bin->left);
         if (bin->right)
-            children.push_back(bin->right.get());
+            children.push_back(bin->right);
+        break;
     }
-    else if (auto cast = dynamic_cast<const CastExpr *>(node))
+    case ASTKind::UnaryOp:
     {
-        children.push_back(cast->targetType.get());
-        if (cast->expression)
-            children.push_back(cast->expression.get());
+        auto unary = cast<UnaryOp>(node);
+        if (unary->operand)
+            children.push_back(unary->operand);
+        break;
+    }
+    case ASTKind::CastExpr:
+    {
+        auto castExpr = cast<CastExpr>(node);
+        children.push_back(castExpr->targetType);
+        if (castExpr->expression)
+            children.push_back(castExpr->expression);
+        break;
     }
-    else if (auto paren = dynamic_cast<const ParenExpr *>(node))
+    case ASTKind::ParenExpr:
     {
+        auto paren = cast<ParenExpr>(node);
         if (paren->expression)
-            children.push_back(paren->expression.get());
+            children.push_back(paren->expression);
+        break;
+    }
+    default: break;
     }
 
     return children;
 }
 
 // 主打印函数
-void printAST(const ASTNode *node, const std::string &prefix, bool isLast)
+void printAST(const ASTNode *node, const std::string &prefix, bool isLast, Context *context)
 {
     if (!node)
         return;
@@ -520,7 +641,7 @@ void printAST(const ASTNode *node, const std::string &prefix, bool isLast)
     std::cout << (isLast ? "`-" : "|-") << "\033[0m";
 
     std::stringstream info;
-    printNodeInfo(node, info);
+    printNodeInfo(node, info, context);
     std::cout << info.str() << std::endl;
 
     // 获取子节点
@@ -531,7 +652,7 @@ void printAST(const ASTNode *node, const std::string &prefix, bool isLast)
     for (size_t i = 0; i < children.size(); ++i)
     {
         bool lastChild = (i == children.size() - 1);
-        printAST(children[i], newPrefix, lastChild);
+        printAST(children[i], newPrefix, lastChild, context);
     }
 
     std::cout << "\033[0m";
@@ -541,4 +662,10 @@ void printAST(const ASTNode *node, const std::string &prefix, bool isLast)
 void printAST(const Program &program)
 {
     printAST(&program, "", true);
+}
+
+// 入口函数，同时输出每个节点的行列信息
+void printAST(Context &context)
+{
+    printAST(&context.program, "", true, &context);
 }
\ No newline at end of file
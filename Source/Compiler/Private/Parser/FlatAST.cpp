@@ -0,0 +1,480 @@
+#include "Parser/FlatAST.hpp"
+#include "Parser/ASTContext.hpp"
+
+#include <cstring>
+
+template <typename T>
+NodeIndex FlatAST::push(const ASTNode *node, const T &record)
+{
+    std::vector<T> &table = std::get<std::vector<T>>(tables);
+
+    const NodeIndex index = static_cast<NodeIndex>(kinds.size());
+    kinds.push_back(T::KIND);
+    offsets.push_back(node->offset);
+    slots.push_back(static_cast<uint32_t>(table.size()));
+    table.push_back(record);
+
+    return index;
+}
+
+template <typename T>
+Flat::ListRef FlatAST::addList(const ASTList<T *> &list)
+{
+    // 子节点自己的列表也会追加到 nodeLists ，所以先收集下标，再一次性追加
+    ASTListBuilder<NodeIndex> items;
+    for (const T *item : list)
+    {
+        items.push_back(add(item));
+    }
+
+    Flat::ListRef result{static_cast<uint32_t>(nodeLists.size()), static_cast<uint32_t>(items.size())};
+    nodeLists.insert(nodeLists.end(), items.data(), items.data() + items.size());
+    return result;
+}
+
+Flat::ListRef FlatAST::addNames(const ASTList<NameId> &list)
+{
+    Flat::ListRef result{static_cast<uint32_t>(nameLists.size()), static_cast<uint32_t>(list.size())};
+    nameLists.insert(nameLists.end(), list.begin(), list.end());
+    return result;
+}
+
+Flat::ListRef FlatAST::addMemberInits(const ASTList<MemberInit> &list)
+{
+    ASTListBuilder<Flat::MemberInit> items;
+    for (const MemberInit &init : list)
+    {
+        items.push_back(Flat::MemberInit{init.name, add(init.value)});
+    }
+
+    Flat::ListRef result{static_cast<uint32_t>(memberInitLists.size()), static_cast<uint32_t>(items.size())};
+    memberInitLists.insert(memberInitLists.end(), items.data(), items.data() + items.size());
+    return result;
+}
+
+NodeIndex FlatAST::add(const ASTNode *node)
+{
+    if (node == nullptr)
+    {
+        return INVALID_NODE;
+    }
+
+    // 先追加子节点，再追加节点本身
+    switch (node->getKind())
+    {
+    case ASTKind::Program:
+    {
+        // Program 不是 FlatAST 中的节点，全局语句通过 addRoot 添加
+        break;
+    }
+    case ASTKind::ModulePath:
+    {
+        return push(node, Flat::ModulePath{addNames(cast<ModulePath>(node)->pathSegments)});
+    }
+    case ASTKind::Type:
+    {
+        auto type = cast<Type>(node);
+        return push(node, Flat::Type{type->isReference, type->isMutReference, type->kind, type->typeName, add(type->modulePath)});
+    }
+    case ASTKind::ImportStmt:
+    {
+        auto importStmt = cast<ImportStmt>(node);
+        Flat::ImportStmt record{add(importStmt->modulePath), !importStmt->symbols.has_value(), {}, importStmt->alias};
+        if (importStmt->symbols)
+        {
+            record.symbols = addNames(*importStmt->symbols);
+        }
+        return push(node, record);
+    }
+    case ASTKind::MemberVarDef:
+    {
+        auto member = cast<MemberVarDef>(node);
+        return push(node, Flat::MemberVarDef{member->isPublic, member->name, add(member->type)});
+    }
+    case ASTKind::StructDef:
+    {
+        auto structDef = cast<StructDef>(node);
+        return push(node, Flat::StructDef{structDef->name, addList(structDef->members)});
+    }
+    case ASTKind::Param:
+    {
+        auto param = cast<Param>(node);
+        const NodeIndex type = add(param->type);
+        return push(node, Flat::Param{param->name, type, add(param->defaultValue)});
+    }
+    case ASTKind::SelfParam:
+    {
+        auto selfParam = cast<SelfParam>(node);
+        return push(node, Flat::SelfParam{selfParam->isRef, selfParam->isMut, add(selfParam->type)});
+    }
+    case ASTKind::MemberFunctionDef:
+    {
+        auto func = cast<MemberFunctionDef>(node);
+        const NodeIndex selfParam = add(func->selfParam);
+        const Flat::ListRef params = addList(func->params);
+        const NodeIndex returnType = add(func->returnType);
+        return push(node, Flat::MemberFunctionDef{func->name, selfParam, params, returnType, add(func->body)});
+    }
+    case ASTKind::StructImpl:
+    {
+        auto impl = cast<StructImpl>(node);
+        return push(node, Flat::StructImpl{impl->structName, addList(impl->methods)});
+    }
+    case ASTKind::FunctionDef:
+    {
+        auto func = cast<FunctionDef>(node);
+        const Flat::ListRef params = addList(func->params);
+        const NodeIndex returnType = add(func->returnType);
+        return push(node, Flat::FunctionDef{func->name, params, returnType, add(func->body)});
+    }
+    case ASTKind::GlobalVarDef:
+    {
+        auto var = cast<GlobalVarDef>(node);
+        const NodeIndex type = add(var->type);
+        return push(node, Flat::GlobalVarDef{var->isMove, var->name, type, add(var->initValue)});
+    }
+    case ASTKind::CompoundStmt:
+    {
+        return push(node, Flat::CompoundStmt{addList(cast<CompoundStmt>(node)->statements)});
+    }
+    case ASTKind::IfStmt:
+    {
+        auto ifStmt = cast<IfStmt>(node);
+        const NodeIndex condition = add(ifStmt->condition);
+        const NodeIndex thenBranch = add(ifStmt->thenBranch);
+        return push(node, Flat::IfStmt{condition, thenBranch, add(ifStmt->elseBranch)});
+    }
+    case ASTKind::ReturnStmt:
+    {
+        return push(node, Flat::ReturnStmt{add(cast<ReturnStmt>(node)->returnValue)});
+    }
+    case ASTKind::DeclStmt:
+    {
+        auto decl = cast<DeclStmt>(node);
+        const NodeIndex type = add(decl->type);
+        return push(node, Flat::DeclStmt{decl->isMutable, decl->name, type, add(decl->initValue)});
+    }
+    case ASTKind::AssignStmt:
+    {
+        auto assign = cast<AssignStmt>(node);
+        const NodeIndex target = add(assign->target);
+        return push(node, Flat::AssignStmt{target, add(assign->value)});
+    }
+    case ASTKind::ExprStmt:
+    {
+        return push(node, Flat::ExprStmt{add(cast<ExprStmt>(node)->expression)});
+    }
+    case ASTKind::ForStmt:
+    {
+        auto forStmt = cast<ForStmt>(node);
+        const NodeIndex iterable = add(forStmt->iterable);
+        return push(node, Flat::ForStmt{forStmt->loopVar, iterable, add(forStmt->body)});
+    }
+    case ASTKind::WhileStmt:
+    {
+        auto whileStmt = cast<WhileStmt>(node);
+        const NodeIndex condition = add(whileStmt->condition);
+        return push(node, Flat::WhileStmt{condition, add(whileStmt->body)});
+    }
+    case ASTKind::ErrorStmt:
+    {
+        return push(node, Flat::ErrorStmt{});
+    }
+    case ASTKind::LiteralExpr:
+    {
+        auto literal = cast<LiteralExpr>(node);
+        return push(node, Flat::LiteralExpr{literal->type, literal->length, literal->literalIndex});
+    }
+    case ASTKind::IdentifierExpr:
+    {
+        return push(node, Flat::IdentifierExpr{cast<IdentifierExpr>(node)->name});
+    }
+    case ASTKind::ModuleIdentifierExpr:
+    {
+        auto identifier = cast<ModuleIdentifierExpr>(node);
+        return push(node, Flat::ModuleIdentifierExpr{add(identifier->modulePath), identifier->name});
+    }
+    case ASTKind::StructInitExpr:
+    {
+        auto init = cast<StructInitExpr>(node);
+        const NodeIndex structType = add(init->structType);
+        return push(node, Flat::StructInitExpr{structType, addMemberInits(init->memberInits)});
+    }
+    case ASTKind::StaticMemberCall:
+    {
+        auto call = cast<StaticMemberCall>(node);
+        const NodeIndex classType = add(call->classType);
+        return push(node, Flat::StaticMemberCall{classType, call->methodName, addList(call->arguments)});
+    }
+    case ASTKind::MemberFunctionCall:
+    {
+        auto call = cast<MemberFunctionCall>(node);
+        const NodeIndex object = add(call->object);
+        return push(node, Flat::MemberFunctionCall{object, call->methodName, addList(call->arguments)});
+    }
+    case ASTKind::FunctionCall:
+    {
+        auto call = cast<FunctionCall>(node);
+        const NodeIndex function = add(call->function);
+        return push(node, Flat::FunctionCall{function, addList(call->arguments)});
+    }
+    case ASTKind::MemberAccess:
+    {
+        auto access = cast<MemberAccess>(node);
+        return push(node, Flat::MemberAccess{add(access->object), access->memberName});
+    }
+    case ASTKind::BinaryOp:
+    {
+        auto binary = cast<BinaryOp>(node);
+        const NodeIndex left = add(binary->left);
+        return push(node, Flat::BinaryOp{left, binary->op, add(binary->right)});
+    }
+    case ASTKind::UnaryOp:
+    {
+        auto unary = cast<UnaryOp>(node);
+        return push(node, Flat::UnaryOp{unary->op, add(unary->operand)});
+    }
+    case ASTKind::CastExpr:
+    {
+        auto castExpr = cast<CastExpr>(node);
+        const NodeIndex targetType = add(castExpr->targetType);
+        return push(node, Flat::CastExpr{targetType, add(castExpr->expression)});
+    }
+    case ASTKind::ParenExpr:
+    {
+        return push(node, Flat::ParenExpr{add(cast<ParenExpr>(node)->expression)});
+    }
+    }
+
+    return INVALID_NODE;
+}
+
+void FlatAST::forEachChild(NodeIndex node, const std::function<void(NodeIndex)> &visit) const
+{
+    auto child = [&](NodeIndex index) {
+        if (index != INVALID_NODE)
+        {
+            visit(index);
+        }
+    };
+
+    auto children = [&](Flat::ListRef list) {
+        for (NodeIndex index : getNodes(list))
+        {
+            visit(index);
+        }
+    };
+
+    switch (getKind(node))
+    {
+    case ASTKind::Type: child(get<Flat::Type>(node).modulePath); break;
+    case ASTKind::ImportStmt: child(get<Flat::ImportStmt>(node).modulePath); break;
+    case ASTKind::MemberVarDef: child(get<Flat::MemberVarDef>(node).type); break;
+    case ASTKind::StructDef: children(get<Flat::StructDef>(node).members); break;
+    case ASTKind::Param:
+    {
+        const Flat::Param &param = get<Flat::Param>(node);
+        child(param.type);
+        child(param.defaultValue);
+        break;
+    }
+    case ASTKind::SelfParam: child(get<Flat::SelfParam>(node).type); break;
+    case ASTKind::MemberFunctionDef:
+    {
+        const Flat::MemberFunctionDef &func = get<Flat::MemberFunctionDef>(node);
+        child(func.selfParam);
+        children(func.params);
+        child(func.returnType);
+        child(func.body);
+        break;
+    }
+    case ASTKind::StructImpl: children(get<Flat::StructImpl>(node).methods); break;
+    case ASTKind::FunctionDef:
+    {
+        const Flat::FunctionDef &func = get<Flat::FunctionDef>(node);
+        children(func.params);
+        child(func.returnType);
+        child(func.body);
+        break;
+    }
+    case ASTKind::GlobalVarDef:
+    {
+        const Flat::GlobalVarDef &var = get<Flat::GlobalVarDef>(node);
+        child(var.type);
+        child(var.initValue);
+        break;
+    }
+    case ASTKind::CompoundStmt: children(get<Flat::CompoundStmt>(node).statements); break;
+    case ASTKind::IfStmt:
+    {
+        const Flat::IfStmt &ifStmt = get<Flat::IfStmt>(node);
+        child(ifStmt.condition);
+        child(ifStmt.thenBranch);
+        child(ifStmt.elseBranch);
+        break;
+    }
+    case ASTKind::ReturnStmt: child(get<Flat::ReturnStmt>(node).returnValue); break;
+    case ASTKind::DeclStmt:
+    {
+        const Flat::DeclStmt &decl = get<Flat::DeclStmt>(node);
+        child(decl.type);
+        child(decl.initValue);
+        break;
+    }
+    case ASTKind::AssignStmt:
+    {
+        const Flat::AssignStmt &assign = get<Flat::AssignStmt>(node);
+        child(assign.target);
+        child(assign.value);
+        break;
+    }
+    case ASTKind::ExprStmt: child(get<Flat::ExprStmt>(node).expression); break;
+    case ASTKind::ForStmt:
+    {
+        const Flat::ForStmt &forStmt = get<Flat::ForStmt>(node);
+        child(forStmt.iterable);
+        child(forStmt.body);
+        break;
+    }
+    case ASTKind::WhileStmt:
+    {
+        const Flat::WhileStmt &whileStmt = get<Flat::WhileStmt>(node);
+        child(whileStmt.condition);
+        child(whileStmt.body);
+        break;
+    }
+    case ASTKind::ModuleIdentifierExpr: child(get<Flat::ModuleIdentifierExpr>(node).modulePath); break;
+    case ASTKind::StructInitExpr:
+    {
+        const Flat::StructInitExpr &init = get<Flat::StructInitExpr>(node);
+        child(init.structType);
+        for (const Flat::MemberInit &member : getMemberInits(init.memberInits))
+        {
+            child(member.value);
+        }
+        break;
+    }
+    case ASTKind::StaticMemberCall:
+    {
+        const Flat::StaticMemberCall &call = get<Flat::StaticMemberCall>(node);
+        child(call.classType);
+        children(call.arguments);
+        break;
+    }
+    case ASTKind::MemberFunctionCall:
+    {
+        const Flat::MemberFunctionCall &call = get<Flat::MemberFunctionCall>(node);
+        child(call.object);
+        children(call.arguments);
+        break;
+    }
+    case ASTKind::FunctionCall:
+    {
+        const Flat::FunctionCall &call = get<Flat::FunctionCall>(node);
+        child(call.function);
+        children(call.arguments);
+        break;
+    }
+    case ASTKind::MemberAccess: child(get<Flat::MemberAccess>(node).object); break;
+    case ASTKind::BinaryOp:
+    {
+        const Flat::BinaryOp &binary = get<Flat::BinaryOp>(node);
+        child(binary.left);
+        child(binary.right);
+        break;
+    }
+    case ASTKind::UnaryOp: child(get<Flat::UnaryOp>(node).operand); break;
+    case ASTKind::CastExpr:
+    {
+        const Flat::CastExpr &castExpr = get<Flat::CastExpr>(node);
+        child(castExpr.targetType);
+        child(castExpr.expression);
+        break;
+    }
+    case ASTKind::ParenExpr: child(get<Flat::ParenExpr>(node).expression); break;
+    default: break;
+    }
+}
+
+// 每个数组写成元素数量加上原始字节
+template <typename T>
+static void writeArray(std::vector<std::byte> &bytes, const std::vector<T> &array)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    const uint64_t count = array.size();
+    const size_t position = bytes.size();
+
+    bytes.resize(position + sizeof(count) + sizeof(T) * array.size());
+    std::memcpy(bytes.data() + position, &count, sizeof(count));
+
+    if (!array.empty())
+    {
+        std::memcpy(bytes.data() + position + sizeof(count), array.data(), sizeof(T) * array.size());
+    }
+}
+
+template <typename T>
+static void readArray(std::span<const std::byte> &bytes, std::vector<T> &array)
+{
+    uint64_t count = 0;
+
+    if (bytes.size() < sizeof(count))
+    {
+        throw std::runtime_error("truncated FlatAST data");
+    }
+
+    std::memcpy(&count, bytes.data(), sizeof(count));
+    bytes = bytes.subspan(sizeof(count));
+
+    if (count > bytes.size() / sizeof(T))
+    {
+        throw std::runtime_error("truncated FlatAST data");
+    }
+
+    array.resize(count);
+
+    if (count != 0)
+    {
+        std::memcpy(array.data(), bytes.data(), sizeof(T) * count);
+    }
+
+    bytes = bytes.subspan(sizeof(T) * count);
+}
+
+std::vector<std::byte> FlatAST::serialize() const
+{
+    std::vector<std::byte> bytes;
+
+    writeArray(bytes, kinds);
+    writeArray(bytes, offsets);
+    writeArray(bytes, slots);
+    std::apply([&](const auto &...table) { (writeArray(bytes, table), ...); }, tables);
+    writeArray(bytes, nodeLists);
+    writeArray(bytes, nameLists);
+    writeArray(bytes, memberInitLists);
+    writeArray(bytes, roots);
+
+    return bytes;
+}
+
+FlatAST FlatAST::deserialize(std::span<const std::byte> bytes)
+{
+    FlatAST ast;
+
+    readArray(bytes, ast.kinds);
+    readArray(bytes, ast.offsets);
+    readArray(bytes, ast.slots);
+    std::apply([&](auto &...table) { (readArray(bytes, table), ...); }, ast.tables);
+    readArray(bytes, ast.nodeLists);
+    readArray(bytes, ast.nameLists);
+    readArray(bytes, ast.memberInitLists);
+    readArray(bytes, ast.roots);
+
+    return ast;
+}
+
+void FlatAST::clear()
+{
+    *this = FlatAST();
+}
\ No newline at end of file
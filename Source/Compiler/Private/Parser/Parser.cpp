@@ -1,113 +1,497 @@
 #include "Parser/Parser.hpp"
 #include "Lexer/Token.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Parser/ASTPrinter.hpp"
+#include "Parser/OperatorTable.hpp"
 
-void Parser::initLineInformation(std::unique_ptr<ASTNode> &node)
-{
-    node->col = currentToken().col;
-    node->line = currentToken().line;
-    node->lineStart = currentToken().lineStart;
-}
+#include <algorithm>
+#include <unordered_map>
 
 void Parser::run()
 {
-    tokenStream = &(context->tokenStream);
+    if (context->options.streamingLexer)
+    {
+        tokens = TokenCursor(std::make_unique<Lexer>(context));
+    }
+    else
+    {
+        tokens = TokenCursor(&context->tokenStream);
+    }
+
+    const bool streaming = context->options.streamingLexer;
+    const bool parallelBodies = context->options.parserThreads > 1 && !context->options.lazyFunctionBodies && !streaming;
+
+    lazyBodies = (context->options.lazyFunctionBodies || parallelBodies) && !streaming;
+    readyForBodies = !streaming;
+
+    // 并行解析时函数体中的错误晚于之后的全局声明中的错误发现，先保存起来，最后按位置报告
+    std::vector<Diagnostic> bufferedDiagnostics;
+    if (parallelBodies)
+    {
+        diagnosticBuffer = &bufferedDiagnostics;
+    }
+
     auto &program = context->program;
 
     while (!finished())
     {
         program.globalStatements.push_back(parseGlobalStatement());
+
+        // 刚解析完的节点还在缓存中，立即展开
+        if (context->options.buildFlatAST && !lazyBodies)
+        {
+            context->flatAST.addRoot(program.globalStatements.back());
+        }
+    }
+
+    if (parallelBodies)
+    {
+        parseBodiesInParallel(context->options.parserThreads);
+
+        diagnosticBuffer = nullptr;
+        std::stable_sort(bufferedDiagnostics.begin(), bufferedDiagnostics.end(), [](const Diagnostic &a, const Diagnostic &b) { return a.position < b.position; });
+
+        for (Diagnostic &diagnostic : bufferedDiagnostics)
+        {
+            context->report(diagnostic.level, std::move(diagnostic.msg), diagnostic.position, diagnostic.length);
+        }
+    }
+    else if (lazyBodies)
+    {
+        parseReachableBodies();
+    }
+
+    // 跳过函数体时要等到函数体解析完才能展开
+    if (lazyBodies && context->options.buildFlatAST)
+    {
+        for (ASTNode *node : program.globalStatements)
+        {
+            context->flatAST.addRoot(node);
+        }
     }
 }
 
-std::unique_ptr<ASTNode> Parser::parseGlobalStatement()
+void Parser::parseBody(FunctionDef *func)
 {
-    // 移除导入语句(IMPT)相关代码
-    if (check(TokenCode::STRUCT))
+    if (func->hasPendingBody())
     {
-        return parseStructDefinition();
+        func->body = parseSkippedBody(func->bodyTokenBegin, func->offset);
     }
-    else if (check(TokenCode::IMPL))
+}
+
+void Parser::parseBody(MemberFunctionDef *method)
+{
+    if (method->hasPendingBody())
     {
-        return parseStructImplementation();
+        method->body = parseSkippedBody(method->bodyTokenBegin, method->offset);
     }
-    else if (check(TokenCode::FN))
+}
+
+void Parser::parseReachableBodies()
+{
+    std::unordered_map<NameId, FunctionDef *> functions;
+    std::unordered_map<NameId, std::vector<MemberFunctionDef *>> methods;
+
+    for (ASTNode *node : context->program.globalStatements)
     {
-        return parseFunctionDefinition();
+        if (auto func = dyn_cast<FunctionDef>(node))
+        {
+            functions.emplace(func->name, func);
+        }
+        else if (auto impl = dyn_cast<StructImpl>(node))
+        {
+            for (MemberFunctionDef *method : impl->methods)
+            {
+                methods[method->name].push_back(method);
+            }
+        }
     }
-    else if (check(TokenCode::LET))
+
+    // 等待扫描函数调用的节点
+    std::vector<const ASTNode *> worklist;
+
+    // 参数的默认值在调用处求值，其中的调用和函数体中的调用一样可以到达
+    auto pushDefaultValues = [&](const ASTList<Param *> &params) {
+        for (const Param *param : params)
+        {
+            if (param->defaultValue != nullptr)
+            {
+                worklist.push_back(param->defaultValue);
+            }
+        }
+    };
+
+    auto visitFunction = [&](NameId name) {
+        auto it = functions.find(name);
+        if (it != functions.end() && it->second->hasPendingBody())
+        {
+            parseBody(it->second);
+            worklist.push_back(it->second->body);
+            pushDefaultValues(it->second->params);
+        }
+    };
+
+    auto visitMethods = [&](NameId name) {
+        auto it = methods.find(name);
+        if (it == methods.end())
+        {
+            return;
+        }
+
+        for (MemberFunctionDef *method : it->second)
+        {
+            if (method->hasPendingBody())
+            {
+                parseBody(method);
+                worklist.push_back(method->body);
+                pushDefaultValues(method->params);
+            }
+        }
+    };
+
+    visitFunction(NameId::get("main"));
+
+    // 全局变量在 main 之前初始化，初始值中调用的函数同样可以到达
+    for (const ASTNode *node : context->program.globalStatements)
     {
-        return parseGlobalVariableDefinition();
+        if (auto var = dyn_cast<GlobalVarDef>(node))
+        {
+            worklist.push_back(var->initValue);
+        }
     }
-    else
+
+    while (!worklist.empty())
+    {
+        const ASTNode *node = worklist.back();
+        worklist.pop_back();
+
+        if (auto call = dyn_cast<FunctionCall>(node))
+        {
+            if (auto callee = dyn_cast<IdentifierExpr>(call->function))
+            {
+                visitFunction(callee->name);
+            }
+        }
+        else if (auto call = dyn_cast<MemberFunctionCall>(node))
+        {
+            visitMethods(call->methodName);
+        }
+        else if (auto call = dyn_cast<StaticMemberCall>(node))
+        {
+            visitMethods(call->methodName);
+        }
+
+        for (const ASTNode *child : getChildren(node))
+        {
+            worklist.push_back(child);
+        }
+    }
+}
+
+void Parser::parseBodiesInParallel(size_t threadCount)
+{
+    struct PendingBody
+    {
+        Stmt **body;
+        uint32_t tokenBegin;
+        uint32_t tokenEnd;
+        uint32_t offset;
+    };
+
+    // 按源代码顺序收集所有跳过的函数体
+    std::vector<PendingBody> pending;
+    size_t totalTokens = 0;
+
+    auto addPending = [&](auto *func) {
+        if (func->hasPendingBody())
+        {
+            pending.push_back({&func->body, func->bodyTokenBegin, func->bodyTokenEnd, func->offset});
+            totalTokens += func->bodyTokenEnd - func->bodyTokenBegin;
+        }
+    };
+
+    for (ASTNode *node : context->program.globalStatements)
+    {
+        if (auto func = dyn_cast<FunctionDef>(node))
+        {
+            addPending(func);
+        }
+        else if (auto impl = dyn_cast<StructImpl>(node))
+        {
+            for (MemberFunctionDef *method : impl->methods)
+            {
+                addPending(method);
+            }
+        }
+    }
+
+    struct BodyChunk
+    {
+        size_t first = 0;
+        size_t last = 0;
+
+        ASTContext astContext;
+        std::vector<Diagnostic> diagnostics;
+    };
+
+    // 每个分块包含大致相同数量的 Token ，分块数量多于线程数量，先完成的线程可以继续领取下一个分块
+    const size_t chunkCount = std::min(threadCount * 4, pending.size());
+
+    if (chunkCount <= 1)
+    {
+        for (PendingBody &body : pending)
+        {
+            *body.body = parseSkippedBody(body.tokenBegin, body.offset);
+        }
+        return;
+    }
+
+    std::vector<BodyChunk> chunks(chunkCount);
+    size_t tokensSoFar = 0;
+    size_t index = 0;
+
+    for (size_t i = 0; i < chunkCount; i++)
+    {
+        chunks[i].first = index;
+
+        while (index < pending.size() && (i + 1 == chunkCount || tokensSoFar < totalTokens * (i + 1) / chunkCount))
+        {
+            tokensSoFar += pending[index].tokenEnd - pending[index].tokenBegin;
+            index++;
+        }
+
+        chunks[i].last = index;
+    }
+
+    {
+        ThreadPool threadPool(std::min(threadCount, chunkCount));
+
+        for (BodyChunk &chunk : chunks)
+        {
+            threadPool.submit([this, &chunk, &pending] {
+                Parser parser(context);
+                parser.tokens = TokenCursor(&context->tokenStream);
+                parser.knownStructs = knownStructs;
+                parser.readyForBodies = true;
+                parser.astContext = &chunk.astContext;
+                parser.diagnosticBuffer = &chunk.diagnostics;
+
+                for (size_t i = chunk.first; i < chunk.last; i++)
+                {
+                    *pending[i].body = parser.parseSkippedBody(pending[i].tokenBegin, pending[i].offset);
+                }
+            });
+        }
+
+        threadPool.wait();
+    }
+
+    for (BodyChunk &chunk : chunks)
+    {
+        getASTContext().adopt(std::move(chunk.astContext));
+        diagnosticBuffer->insert(diagnosticBuffer->end(), std::make_move_iterator(chunk.diagnostics.begin()), std::make_move_iterator(chunk.diagnostics.end()));
+    }
+}
+
+void Parser::prepareForBodies()
+{
+    if (readyForBodies)
+    {
+        return;
+    }
+
+    // 由一个新的 Parser 解析时，结构体都已经定义过了
+    tokens = TokenCursor(&context->tokenStream);
+    for (ASTNode *node : context->program.globalStatements)
+    {
+        if (auto structDef = dyn_cast<StructDef>(node))
+        {
+            addKnownStruct(structDef->name);
+        }
+    }
+
+    readyForBodies = true;
+}
+
+void Parser::skipFunctionBody(uint32_t &begin, uint32_t &end)
+{
+    begin = (uint32_t)tokens.getPosition();
+    consume(TokenCode::LBRACE, "expected '{' before function body");
+
+    size_t depth = 1;
+    while (!finished() && depth > 0)
+    {
+        switch (tokens.peek()->code)
+        {
+        case TokenCode::LBRACE:
+            depth++;
+            break;
+        case TokenCode::RBRACE:
+            depth--;
+            break;
+        case TokenCode::FN:
+        case TokenCode::STRUCT:
+        case TokenCode::IMPL:
+            // 和 parseCompoundStatement 一样，缺少 '}' 时在下一个全局声明之前结束，解析函数体时再报告错误
+            end = (uint32_t)tokens.getPosition();
+            return;
+        default:
+            break;
+        }
+
+        advance();
+    }
+
+    end = (uint32_t)tokens.getPosition();
+}
+
+Stmt *Parser::parseSkippedBody(uint32_t begin, uint32_t offset)
+{
+    prepareForBodies();
+    tokens.rewind(begin);
+
+    try
     {
-        Logger::LogInfo logInfo;
-        initLogInfo(currentToken(), logInfo, "illegal global statement");
-        Logger::Log(Logger::LogLevel::ERROR, logInfo);
+        return parseCompoundStatement();
+    }
+    catch (const ParseError &)
+    {
+        return createNode<ErrorStmt>(offset);
+    }
+}
+
+ASTNode *Parser::parseGlobalStatement()
+{
+    const size_t start = tokens.getPosition();
+    const uint32_t offset = currentToken().offset;
+
+    try
+    {
+        // 移除导入语句(IMPT)相关代码
+        if (check(TokenCode::STRUCT))
+        {
+            return parseStructDefinition();
+        }
+        else if (check(TokenCode::IMPL))
+        {
+            return parseStructImplementation();
+        }
+        else if (check(TokenCode::FN))
+        {
+            return parseFunctionDefinition();
+        }
+        else if (check(TokenCode::LET))
+        {
+            return parseGlobalVariableDefinition();
+        }
+
+        error(currentToken(), "illegal global statement");
+    }
+    catch (const ParseError &)
+    {
+        synchronize(start, false);
+        return createNode<ErrorStmt>(offset);
+    }
+}
+
+void Parser::synchronize(size_t start, bool insideBlock)
+{
+    if (tokens.getPosition() == start && !finished())
+    {
+        advance();
     }
 
-    return nullptr;
+    while (!finished())
+    {
+        switch (tokens.peek()->code)
+        {
+        case TokenCode::FN:
+        case TokenCode::STRUCT:
+        case TokenCode::IMPL:
+        case TokenCode::LET:
+            return;
+        case TokenCode::RBRACE:
+            if (insideBlock)
+            {
+                return;
+            }
+            break;
+        case TokenCode::SEMI:
+            if (insideBlock)
+            {
+                advance();
+                return;
+            }
+            break;
+        default:
+            break;
+        }
+
+        advance();
+    }
 }
 
 // 移除 parseImptStatement() 函数
 
-std::unique_ptr<StructDef> Parser::parseStructDefinition()
+StructDef *Parser::parseStructDefinition()
 {
+    auto structDef = createNode<StructDef>();
     match(TokenCode::STRUCT);
 
-    auto structDef = std::make_unique<StructDef>();
-
-    createSnapshot();
-    structDef->name = consume(TokenCode::IDENTIFIER, "expect an identifier as the struct name").value;
+    Token nameToken = consume(TokenCode::IDENTIFIER, "expect an identifier as the struct name");
+    structDef->name = getTokenName(nameToken);
 
-    if (knownTypes.count(structDef->name) > 0)
+    if (isKnownStruct(structDef->name))
     {
-        backToSnapshot();
-        consume(TokenCode::UNDEFINED, "mutidefined struct '" + structDef->name + "'");
+        reportError(nameToken, "mutidefined struct '" + std::string(structDef->name.str()) + "'");
     }
 
     consume(TokenCode::LBRACE, "expect a '{' after struct name");
 
+    ASTListBuilder<MemberVarDef *> members;
     while (!match(TokenCode::RBRACE))
     {
-        structDef->members.push_back(parseMemberVariableDefinition());
+        members.push_back(parseMemberVariableDefinition());
     }
+    structDef->members = createList(members);
 
-    knownTypes.insert(structDef->name);
+    addKnownStruct(structDef->name);
     return structDef;
 }
 
-std::unique_ptr<StructImpl> Parser::parseStructImplementation()
+StructImpl *Parser::parseStructImplementation()
 {
+    auto impl = createNode<StructImpl>();
     match(TokenCode::IMPL);
 
-    auto impl = std::make_unique<StructImpl>();
-    createSnapshot();
-    impl->structName = consume(TokenCode::IDENTIFIER, "expect a struct name after impl").value;
+    Token nameToken = consume(TokenCode::IDENTIFIER, "expect a struct name after impl");
+    impl->structName = getTokenName(nameToken);
 
-    if (knownTypes.count(impl->structName) == 0)
+    if (!isKnownStruct(impl->structName))
     {
-        backToSnapshot();
-        consume(TokenCode::UNDEFINED, "undefined struct '" + impl->structName + "'");
+        reportError(nameToken, "undefined struct '" + std::string(impl->structName.str()) + "'");
     }
 
     consume(TokenCode::LBRACE, "expect a '{'");
 
+    ASTListBuilder<MemberFunctionDef *> methods;
     while (!check(TokenCode::RBRACE))
     {
-        impl->methods.push_back(parseMemberFunctionDefinition());
+        methods.push_back(parseMemberFunctionDefinition());
     }
+    impl->methods = createList(methods);
 
     consume(TokenCode::RBRACE, "expect a '}'");
 
     return impl;
 }
 
-std::unique_ptr<FunctionDef> Parser::parseFunctionDefinition()
+FunctionDef *Parser::parseFunctionDefinition()
 {
+    auto func = createNode<FunctionDef>();
     match(TokenCode::FN);
 
-    auto func = std::make_unique<FunctionDef>();
-    func->name = consume(TokenCode::IDENTIFIER, "expect a function name").value;
+    func->name = getTokenName(consume(TokenCode::IDENTIFIER, "expect a function name"));
 
     consume(TokenCode::LPAREN, "expect a '(' after function name");
     func->params = parseParameterList();
@@ -118,15 +502,24 @@ std::unique_ptr<FunctionDef> Parser::parseFunctionDefinition()
         func->returnType = parseType();
     }
 
-    func->body = parseCompoundStatement();
+    if (lazyBodies)
+    {
+        skipFunctionBody(func->bodyTokenBegin, func->bodyTokenEnd);
+    }
+    else
+    {
+        func->body = parseCompoundStatement();
+    }
     return func;
 }
 
-std::unique_ptr<GlobalVarDef> Parser::parseGlobalVariableDefinition()
+GlobalVarDef *Parser::parseGlobalVariableDefinition()
 {
-    auto var = std::make_unique<GlobalVarDef>();
+    auto var = createNode<GlobalVarDef>();
+    match(TokenCode::LET);
+
     var->isMove = match(TokenCode::MOVE);
-    var->name = consume(TokenCode::IDENTIFIER, "expect variable name").value;
+    var->name = getTokenName(consume(TokenCode::IDENTIFIER, "expect variable name"));
 
     if (match(TokenCode::COLON))
     {
@@ -142,11 +535,11 @@ std::unique_ptr<GlobalVarDef> Parser::parseGlobalVariableDefinition()
 
 // 移除 parseModulePath() 函数
 
-std::unique_ptr<MemberVarDef> Parser::parseMemberVariableDefinition()
+MemberVarDef *Parser::parseMemberVariableDefinition()
 {
-    auto member = std::make_unique<MemberVarDef>();
+    auto member = createNode<MemberVarDef>();
     member->isPublic = match(TokenCode::PUB);
-    member->name = consume(TokenCode::IDENTIFIER, "expected a member name").value;
+    member->name = getTokenName(consume(TokenCode::IDENTIFIER, "expected a member name"));
 
     consume(TokenCode::COLON, "expected ':' after member name");
     member->type = parseType();
@@ -155,9 +548,9 @@ std::unique_ptr<MemberVarDef> Parser::parseMemberVariableDefinition()
     return member;
 }
 
-std::unique_ptr<Type> Parser::parseType()
+Type *Parser::parseType()
 {
-    auto type = std::make_unique<Type>();
+    auto type = createNode<Type>();
 
     if (match(TokenCode::REFERENCE))
     {
@@ -166,47 +559,45 @@ std::unique_ptr<Type> Parser::parseType()
     }
 
     // 移除模块限定类型相关代码
-    if ((size_t)currentToken().code >= TYPE_KEYWORD_BEGIN && (size_t)currentToken().code <= TYPE_KEYWORD_END)
+    if (isPrimitiveType())
     {
         type->kind = Type::TypeKind::Primitive;
-        type->typeName = currentToken().value;
+        type->typeName = getTokenName(currentToken());
         advance();
         return type;
     }
 
     if (check(TokenCode::IDENTIFIER))
     {
-        if (knownTypes.count(currentToken().value) == 0)
+        if (!isKnownStruct(getTokenName(currentToken())))
         {
-            consume(TokenCode::UNDEFINED, "undefined type '" + currentToken().value + "'");
+            reportError(currentToken(), "undefined type '" + std::string(getTokenValue(currentToken())) + "'");
         }
 
         type->kind = Type::TypeKind::Custom;
-        type->typeName = currentToken().value;
+        type->typeName = getTokenName(currentToken());
         advance();
         return type;
     }
 
-    Logger::LogInfo logInfo;
-    initLogInfo(currentToken(), logInfo, "expected type");
-    Logger::Log(Logger::LogLevel::ERROR, logInfo);
-
-    return nullptr;
+    error(currentToken(), "expected type");
 }
 
-std::unique_ptr<MemberFunctionDef> Parser::parseMemberFunctionDefinition()
+MemberFunctionDef *Parser::parseMemberFunctionDefinition()
 {
+    auto func = createNode<MemberFunctionDef>();
     consume(TokenCode::FN, "expect 'fn' for member function");
 
-    auto func = std::make_unique<MemberFunctionDef>();
-    func->name = consume(TokenCode::IDENTIFIER, "expected function name").value;
+    func->name = getTokenName(consume(TokenCode::IDENTIFIER, "expected function name"));
 
     consume(TokenCode::LPAREN, "expected '(' after function name");
 
     // 修复：self参数是可选的
-    if (match(TokenCode::SELF))
+    if (check(TokenCode::SELF))
     {
-        auto selfParam = std::make_unique<SelfParam>();
+        auto selfParam = createNode<SelfParam>();
+        advance();
+
         selfParam->isRef = false;
         selfParam->isMut = false;
 
@@ -220,7 +611,7 @@ std::unique_ptr<MemberFunctionDef> Parser::parseMemberFunctionDefinition()
             selfParam->type = parseType();
         }
 
-        func->selfParam = std::move(selfParam);
+        func->selfParam = selfParam;
 
         if (match(TokenCode::COMMA))
         {
@@ -239,13 +630,20 @@ std::unique_ptr<MemberFunctionDef> Parser::parseMemberFunctionDefinition()
         func->returnType = parseType();
     }
 
-    func->body = parseCompoundStatement();
+    if (lazyBodies)
+    {
+        skipFunctionBody(func->bodyTokenBegin, func->bodyTokenEnd);
+    }
+    else
+    {
+        func->body = parseCompoundStatement();
+    }
     return func;
 }
 
-std::vector<std::unique_ptr<Param>> Parser::parseParameterList()
+ASTList<Param *> Parser::parseParameterList()
 {
-    std::vector<std::unique_ptr<Param>> params;
+    ASTListBuilder<Param *> params;
 
     if (!check(TokenCode::RPAREN))
     {
@@ -255,13 +653,13 @@ std::vector<std::unique_ptr<Param>> Parser::parseParameterList()
         } while (match(TokenCode::COMMA));
     }
 
-    return params;
+    return createList(params);
 }
 
-std::unique_ptr<Param> Parser::parseParameter()
+Param *Parser::parseParameter()
 {
-    auto param = std::make_unique<Param>();
-    param->name = consume(TokenCode::IDENTIFIER, "expected parameter name").value;
+    auto param = createNode<Param>();
+    param->name = getTokenName(consume(TokenCode::IDENTIFIER, "expected parameter name"));
 
     // 修复：移除错误的参数名覆盖
     consume(TokenCode::COLON, "expected ':'");
@@ -276,23 +674,52 @@ std::unique_ptr<Param> Parser::parseParameter()
     return param;
 }
 
-std::unique_ptr<CompoundStmt> Parser::parseCompoundStatement()
+CompoundStmt *Parser::parseCompoundStatement()
 {
+    auto block = createNode<CompoundStmt>();
     match(TokenCode::LBRACE);
 
-    auto block = std::make_unique<CompoundStmt>();
-
-    while (!check(TokenCode::RBRACE))
+    // 缺少 '}' 时在下一个全局声明之前结束，由下面的 consume 报告错误
+    ASTListBuilder<Stmt *> statements;
+    while (!check(TokenCode::RBRACE) && !isOneOf({TokenCode::FN, TokenCode::STRUCT, TokenCode::IMPL}))
     {
-        block->statements.push_back(parseStatement());
+        statements.push_back(parseStatementOrRecover());
     }
+    block->statements = createList(statements);
 
     consume(TokenCode::RBRACE, "expected '}' after compound statement");
     return block;
 }
 
-std::unique_ptr<Stmt> Parser::parseStatement()
+Stmt *Parser::parseStatementOrRecover()
+{
+    const size_t start = tokens.getPosition();
+    const uint32_t offset = currentToken().offset;
+
+    try
+    {
+        return parseStatement();
+    }
+    catch (const ParseError &)
+    {
+        synchronize(start, true);
+        return createNode<ErrorStmt>(offset);
+    }
+}
+
+void Parser::enterNesting(const Token &token)
 {
+    if (++nestingDepth > context->options.maxNestingDepth)
+    {
+        error(token, "nesting too deep, the limit is " + std::to_string(context->options.maxNestingDepth));
+    }
+}
+
+Stmt *Parser::parseStatement()
+{
+    NestingGuard guard(this);
+    enterNesting(currentToken());
+
     if (check(TokenCode::LBRACE))
     {
         return parseCompoundStatement();
@@ -323,23 +750,23 @@ std::unique_ptr<Stmt> Parser::parseStatement()
 
     if (match(TokenCode::ASSIGN))
     {
-        auto assign = std::make_unique<AssignStmt>();
-        assign->target = std::move(expr);
+        auto assign = createNode<AssignStmt>(expr->offset);
+        assign->target = expr;
         assign->value = parseExpression();
         consume(TokenCode::SEMI, "expected ';' after assignment");
         return assign;
     }
 
-    auto exprStmt = std::make_unique<ExprStmt>();
-    exprStmt->expression = std::move(expr);
+    auto exprStmt = createNode<ExprStmt>(expr->offset);
+    exprStmt->expression = expr;
     consume(TokenCode::SEMI, "expected ';' after expression");
     return exprStmt;
 }
 
-std::unique_ptr<IfStmt> Parser::parseIfStmt()
+IfStmt *Parser::parseIfStmt()
 {
+    auto ifStmt = createNode<IfStmt>();
     match(TokenCode::IF);
-    auto ifStmt = std::make_unique<IfStmt>();
 
     consume(TokenCode::LPAREN, "expected '(' after 'if'");
     ifStmt->condition = parseExpression();
@@ -355,10 +782,10 @@ std::unique_ptr<IfStmt> Parser::parseIfStmt()
     return ifStmt;
 }
 
-std::unique_ptr<ReturnStmt> Parser::parseReturnStmt()
+ReturnStmt *Parser::parseReturnStmt()
 {
+    auto returnStmt = createNode<ReturnStmt>();
     match(TokenCode::RET);
-    auto returnStmt = std::make_unique<ReturnStmt>();
 
     // 修复：正确处理无分号的返回语句
     if (!check(TokenCode::SEMI))
@@ -370,13 +797,13 @@ std::unique_ptr<ReturnStmt> Parser::parseReturnStmt()
     return returnStmt;
 }
 
-std::unique_ptr<DeclStmt> Parser::parseDeclarationStatement()
+DeclStmt *Parser::parseDeclarationStatement()
 {
+    auto decl = createNode<DeclStmt>();
     match(TokenCode::LET);
-    auto decl = std::make_unique<DeclStmt>();
 
     decl->isMutable = match(TokenCode::MUT);
-    decl->name = consume(TokenCode::IDENTIFIER, "expected an identifier as the variable name").value;
+    decl->name = getTokenName(consume(TokenCode::IDENTIFIER, "expected an identifier as the variable name"));
 
     if (match(TokenCode::COLON))
     {
@@ -392,13 +819,13 @@ std::unique_ptr<DeclStmt> Parser::parseDeclarationStatement()
     return decl;
 }
 
-std::unique_ptr<ForStmt> Parser::parseForLoop()
+ForStmt *Parser::parseForLoop()
 {
+    auto forStmt = createNode<ForStmt>();
     match(TokenCode::FOR);
-    auto forStmt = std::make_unique<ForStmt>();
 
     consume(TokenCode::LPAREN, "expected '(' after 'for'");
-    forStmt->loopVar = consume(TokenCode::IDENTIFIER, "expected an identifier as the loop variable").value;
+    forStmt->loopVar = getTokenName(consume(TokenCode::IDENTIFIER, "expected an identifier as the loop variable"));
     consume(TokenCode::IN, "expected keyword 'in'");
     forStmt->iterable = parseExpression();
     consume(TokenCode::RPAREN, "expected ')'");
@@ -407,10 +834,10 @@ std::unique_ptr<ForStmt> Parser::parseForLoop()
     return forStmt;
 }
 
-std::unique_ptr<WhileStmt> Parser::parseWhileLoop()
+WhileStmt *Parser::parseWhileLoop()
 {
+    auto whileLoop = createNode<WhileStmt>();
     match(TokenCode::WHILE);
-    auto whileLoop = std::make_unique<WhileStmt>();
 
     consume(TokenCode::LPAREN, "expected '(' after 'while'");
     whileLoop->condition = parseExpression();
@@ -421,87 +848,166 @@ std::unique_ptr<WhileStmt> Parser::parseWhileLoop()
 }
 
 // 表达式解析
-std::unique_ptr<Expr> Parser::parseExpression()
+Expr *Parser::parseExpression()
 {
-    return parseBinaryExpression(0);
-}
+    // 一个还没有结合完成的运算符或者括号
+    struct Frame
+    {
+        enum class Kind : uint8_t
+        {
+            Binary,
+            Prefix,
+            Paren
+        };
 
-std::unique_ptr<Expr> Parser::parseBinaryExpression(int minPrecedence)
-{
-    auto left = parsePrimary();
-    left = parseMemberAccessChain(std::move(left));
+        Kind kind;
+        // 进入这一层之前的最小绑定强度
+        uint8_t minBindingPower;
+        uint32_t offset;
+
+        // 二元运算符的左侧操作数
+        Expr *left = nullptr;
+        BinaryOpKind binaryOp = BinaryOpKind::Add;
+        UnaryOpKind unaryOp = UnaryOpKind::Not;
+    };
+
+    NestingGuard guard(this);
+    enterNesting(currentToken());
+
+    std::vector<Frame> stack;
+    uint8_t minBindingPower = 0;
 
     while (true)
     {
-        Token opToken = currentToken();
-        int precedence = getPrecedence(opToken.code);
+        // 读取操作数前面的前缀运算符和左括号
+        while (true)
+        {
+            const Token &token = currentToken();
+            const PrefixOperatorInfo &prefix = getPrefixOperator(token.code);
 
-        if (precedence <= minPrecedence)
-            break;
+            if (prefix.isOperator)
+            {
+                enterNesting(token);
+                stack.push_back(Frame{Frame::Kind::Prefix, minBindingPower, token.offset, nullptr, BinaryOpKind::Add, prefix.kind});
+                minBindingPower = PREFIX_BINDING_POWER;
+            }
+            else if (token.code == TokenCode::LPAREN)
+            {
+                enterNesting(token);
+                stack.push_back(Frame{Frame::Kind::Paren, minBindingPower, token.offset});
+                minBindingPower = 0;
+            }
+            else
+            {
+                break;
+            }
 
-        advance(); // 消耗运算符
-        auto right = parseBinaryExpression(precedence + 1);
+            advance();
+        }
 
-        auto binary = std::make_unique<BinaryOp>();
-        binary->left = std::move(left);
-        binary->op = opToken.value;
-        binary->right = std::move(right);
-        left = std::move(binary);
-    }
+        Expr *left = parsePostfix(parsePrimary());
 
-    return left;
-}
+        // 结合栈顶的运算符，直到下一个二元运算符可以继续向右结合
+        while (true)
+        {
+            Token opToken = currentToken();
+            const BinaryOperatorInfo &info = getBinaryOperator(opToken.code);
 
-int Parser::getPrecedence(TokenCode type)
-{
-    switch (type)
-    {
-    case TokenCode::STAR:
-    case TokenCode::SLASH:
-        return 8;
-    case TokenCode::PLUS:
-    case TokenCode::MINUS:
-        return 7;
-    case TokenCode::LT:
-    case TokenCode::LT_EQ:
-    case TokenCode::GT:
-    case TokenCode::GT_EQ:
-        return 6;
-    case TokenCode::EQ_EQ:
-    case TokenCode::NOT_EQ:
-        return 5;
-    case TokenCode::REFERENCE:
-        return 4;
-    case TokenCode::BOR:
-        return 3;
-    case TokenCode::AND:
-        return 2;
-    case TokenCode::OR:
-        return 1;
-    default:
-        return 0;
+            if (info.isOperator() && info.leftBindingPower > minBindingPower)
+            {
+                advance(); // 消耗运算符
+
+                stack.push_back(Frame{Frame::Kind::Binary, minBindingPower, opToken.offset, left, info.kind});
+                minBindingPower = info.rightBindingPower;
+                break;
+            }
+
+            if (stack.empty())
+            {
+                return left;
+            }
+
+            Frame frame = stack.back();
+            stack.pop_back();
+            minBindingPower = frame.minBindingPower;
+
+            switch (frame.kind)
+            {
+            case Frame::Kind::Binary:
+            {
+                auto binary = createNode<BinaryOp>(frame.offset);
+                binary->left = frame.left;
+                binary->op = frame.binaryOp;
+                binary->right = left;
+                left = binary;
+                break;
+            }
+            case Frame::Kind::Prefix:
+            {
+                auto unary = createNode<UnaryOp>(frame.offset);
+                unary->op = frame.unaryOp;
+                unary->operand = left;
+                left = unary;
+                nestingDepth--;
+                break;
+            }
+            case Frame::Kind::Paren:
+            {
+                consume(TokenCode::RPAREN, "expected ')' after expression");
+
+                auto paren = createNode<ParenExpr>(frame.offset);
+                paren->expression = left;
+                left = parsePostfix(paren);
+                nestingDepth--;
+                break;
+            }
+            }
+        }
     }
 }
 
-std::unique_ptr<Expr> Parser::parsePrimary()
+Expr *Parser::parsePostfix(Expr *left)
 {
-    if (match(TokenCode::LPAREN))
+    // 成员访问和成员函数调用比所有运算符都紧
+    while (match(TokenCode::DOT))
     {
-        return parseParenthesized();
+        Token member = consume(TokenCode::IDENTIFIER, "expected member name after '.'");
+
+        if (match(TokenCode::LPAREN))
+        {
+            auto call = createNode<MemberFunctionCall>(member.offset);
+            call->object = left;
+            call->methodName = getTokenName(member);
+            call->arguments = parseArgumentList();
+            consume(TokenCode::RPAREN, "expected ')' after arguments");
+            left = call;
+        }
+        else
+        {
+            auto access = createNode<MemberAccess>(member.offset);
+            access->object = left;
+            access->memberName = getTokenName(member);
+            left = access;
+        }
     }
+    return left;
+}
 
+Expr *Parser::parsePrimary()
+{
     if (isLiteral())
     {
         return parseLiteral();
     }
 
-    if (isTypeStart() && knownTypes.count(currentToken().value) != 0)
+    // 基本类型总是类型转换，结构体名只有后面紧跟 '(' 时才是类型转换，否则可能是结构体初始化
+    if (isPrimitiveType() || (check(TokenCode::IDENTIFIER) && isKnownStruct(getTokenName(currentToken())) && tokens.peek(1) != nullptr && tokens.peek(1)->code == TokenCode::LPAREN))
     {
         auto type = parseType();
 
         consume(TokenCode::LPAREN, "except '(' for type cast");
 
-        return parseCastExpression(std::move(type));
+        return parseCastExpression(type);
     }
 
     if (check(TokenCode::IDENTIFIER))
@@ -511,45 +1017,35 @@ std::unique_ptr<Expr> Parser::parsePrimary()
 
         if (match(TokenCode::LBRACE))
         {
-            return parseStructInitialization(identifier.value);
+            return parseStructInitialization(identifier);
         }
 
         if (match(TokenCode::LPAREN))
         {
-            return parseFunctionCall(identifier.value);
+            return parseFunctionCall(identifier);
         }
 
-        auto id = std::make_unique<IdentifierExpr>();
-        id->name = identifier.value;
-        return parseMemberAccessChain(std::move(id));
+        auto id = createNode<IdentifierExpr>(identifier.offset);
+        id->name = getTokenName(identifier);
+        return id;
     }
 
-    if (match(TokenCode::SELF))
+    if (check(TokenCode::SELF))
     {
-        auto self = std::make_unique<IdentifierExpr>();
-        self->name = "self";
-        return parseMemberAccessChain(std::move(self));
+        auto self = createNode<IdentifierExpr>();
+        advance();
+        self->name = NameId::get("self");
+        return self;
     }
 
-    Logger::LogInfo logInfo;
-    initLogInfo(currentToken(), logInfo, "expected expression");
-    Logger::Log(Logger::LogLevel::ERROR, logInfo);
-
-    return nullptr;
+    error(currentToken(), "expected expression");
 }
 
-std::unique_ptr<ParenExpr> Parser::parseParenthesized()
+LiteralExpr *Parser::parseLiteral()
 {
-    auto expr = std::make_unique<ParenExpr>();
-    expr->expression = parseExpression();
-    consume(TokenCode::RPAREN, "expected ')' after expression");
-    return expr;
-}
-
-std::unique_ptr<LiteralExpr> Parser::parseLiteral()
-{
-    auto literal = std::make_unique<LiteralExpr>();
-    literal->value = currentToken().value;
+    auto literal = createNode<LiteralExpr>();
+    literal->length = currentToken().length;
+    literal->literalIndex = currentToken().literalIndex;
 
     switch (currentToken().code)
     {
@@ -570,9 +1066,7 @@ std::unique_ptr<LiteralExpr> Parser::parseLiteral()
         literal->type = LiteralExpr::LiteralType::Bool;
         break;
     default:
-        Logger::LogInfo logInfo;
-        initLogInfo(currentToken(), logInfo, "invalid literal type");
-        Logger::Log(Logger::LogLevel::ERROR, logInfo);
+        error(currentToken(), "invalid literal type");
     }
 
     advance();
@@ -584,53 +1078,55 @@ bool Parser::isLiteral()
     return isOneOf({TokenCode::INT_LITERAL, TokenCode::FLOAT_LITERAL, TokenCode::STRING_LITERAL, TokenCode::CHAR_LITERAL, TokenCode::BOOLEAN_TRUE, TokenCode::BOOLEAN_FALSE});
 }
 
-std::unique_ptr<CastExpr> Parser::parseCastExpression(std::unique_ptr<Type> type)
+CastExpr *Parser::parseCastExpression(Type *type)
 {
-    auto cast = std::make_unique<CastExpr>();
-    cast->targetType = std::move(type);
+    auto cast = createNode<CastExpr>(type->offset);
+    cast->targetType = type;
     cast->expression = parseExpression();
     consume(TokenCode::RPAREN, "expected ')' after cast expression");
     return cast;
 }
 
-std::unique_ptr<StructInitExpr> Parser::parseStructInitialization(const std::string &typeName)
+StructInitExpr *Parser::parseStructInitialization(const Token &typeToken)
 {
-    auto init = std::make_unique<StructInitExpr>();
+    auto init = createNode<StructInitExpr>(typeToken.offset);
 
-    auto type = std::make_unique<Type>();
+    auto type = createNode<Type>(typeToken.offset);
     type->kind = Type::TypeKind::Custom;
-    type->typeName = typeName;
-    init->structType = std::move(type);
+    type->typeName = getTokenName(typeToken);
+    init->structType = type;
 
     if (!match(TokenCode::RBRACE))
     {
+        ASTListBuilder<MemberInit> memberInits;
         do
         {
-            std::string name = consume(TokenCode::IDENTIFIER, "expected member name").value;
+            NameId name = getTokenName(consume(TokenCode::IDENTIFIER, "expected member name"));
             consume(TokenCode::COLON, "expected ':' after member name");
             auto expr = parseExpression();
-            init->memberInits.emplace_back(name, std::move(expr));
+            memberInits.push_back(MemberInit{name, expr});
         } while (match(TokenCode::COMMA));
 
+        init->memberInits = createList(memberInits);
         consume(TokenCode::RBRACE, "expected '}' after struct initializer");
     }
 
     return init;
 }
 
-std::unique_ptr<Expr> Parser::parseFunctionCall(const std::string &name)
+Expr *Parser::parseFunctionCall(const Token &nameToken)
 {
     // 静态成员调用 (Type::method)
     if (match(TokenCode::DOUBLE_COLON))
     {
-        auto staticCall = std::make_unique<StaticMemberCall>();
+        auto staticCall = createNode<StaticMemberCall>(nameToken.offset);
 
-        auto type = std::make_unique<Type>();
+        auto type = createNode<Type>(nameToken.offset);
         type->kind = Type::TypeKind::Custom;
-        type->typeName = name;
-        staticCall->classType = std::move(type);
+        type->typeName = getTokenName(nameToken);
+        staticCall->classType = type;
 
-        staticCall->methodName = consume(TokenCode::IDENTIFIER, "expected method name").value;
+        staticCall->methodName = getTokenName(consume(TokenCode::IDENTIFIER, "expected method name"));
         consume(TokenCode::LPAREN, "expected '(' after method name");
         staticCall->arguments = parseArgumentList();
         consume(TokenCode::RPAREN, "expected ')' after arguments");
@@ -638,30 +1134,19 @@ std::unique_ptr<Expr> Parser::parseFunctionCall(const std::string &name)
     }
 
     // 普通函数调用
-    auto call = std::make_unique<FunctionCall>();
-    call->function = std::make_unique<IdentifierExpr>();
-    static_cast<IdentifierExpr *>(call->function.get())->name = name;
+    auto call = createNode<FunctionCall>(nameToken.offset);
+    auto function = createNode<IdentifierExpr>(nameToken.offset);
+    function->name = getTokenName(nameToken);
+    call->function = function;
     call->arguments = parseArgumentList();
     consume(TokenCode::RPAREN, "expected ')' after arguments");
 
-    // 检查链式调用 (obj.method())
-    if (match(TokenCode::DOT))
-    {
-        auto memberCall = std::make_unique<MemberFunctionCall>();
-        memberCall->object = std::move(call);
-        memberCall->methodName = consume(TokenCode::IDENTIFIER, "expected method name").value;
-        consume(TokenCode::LPAREN, "expected '(' after method name");
-        memberCall->arguments = parseArgumentList();
-        consume(TokenCode::RPAREN, "expected ')' after arguments");
-        return memberCall;
-    }
-
     return call;
 }
 
-std::vector<std::unique_ptr<Expr>> Parser::parseArgumentList()
+ASTList<Expr *> Parser::parseArgumentList()
 {
-    std::vector<std::unique_ptr<Expr>> args;
+    ASTListBuilder<Expr *> args;
 
     if (!check(TokenCode::RPAREN))
     {
@@ -671,36 +1156,11 @@ std::vector<std::unique_ptr<Expr>> Parser::parseArgumentList()
         } while (match(TokenCode::COMMA));
     }
 
-    return args;
-}
-
-std::unique_ptr<Expr> Parser::parseMemberAccessChain(std::unique_ptr<Expr> left)
-{
-    while (match(TokenCode::DOT))
-    {
-        Token member = consume(TokenCode::IDENTIFIER, "expected member name after '.'");
-
-        if (match(TokenCode::LPAREN))
-        {
-            auto call = std::make_unique<MemberFunctionCall>();
-            call->object = std::move(left);
-            call->methodName = member.value;
-            call->arguments = parseArgumentList();
-            consume(TokenCode::RPAREN, "expected ')' after arguments");
-            left = std::move(call);
-        }
-        else
-        {
-            auto access = std::make_unique<MemberAccess>();
-            access->object = std::move(left);
-            access->memberName = member.value;
-            left = std::move(access);
-        }
-    }
-    return left;
+    return createList(args);
 }
 
-bool Parser::isTypeStart()
+bool Parser::isPrimitiveType()
 {
-    return isOneOf({TokenCode::I8, TokenCode::I16, TokenCode::I32, TokenCode::I64, TokenCode::F32, TokenCode::F64, TokenCode::BOOL, TokenCode::CHAR, TokenCode::IDENTIFIER});
+    const size_t code = (size_t)currentToken().code;
+    return code >= TYPE_KEYWORD_BEGIN && code <= TYPE_KEYWORD_END;
 }
\ No newline at end of file
@@ -1,15 +1,26 @@
 /**
  * Copyright 2025, LiserverYang. All rights reserved.
+ * 此文件定义了语义分析器 Analyzer
  */
 
 #pragma once
 
+#include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include "Analyzer/SymbolTable.hpp"
+#include "Analyzer/Types.hpp"
 #include "Core/Pass.hpp"
 
+/**
+ * Analyzer 是语义分析器，检查名字是否定义以及类型是否匹配
+ * 它只通过引用读取 AST ，按照节点的 ASTKind 分派，表达式的类型作为返回值向上传递，不为节点分配内存
+ * 先收集所有全局声明，所以函数和结构体可以在定义之前使用，全局变量只能使用之前定义的全局变量
+ * 收集完成后全局声明不再修改，函数体之间互不影响，CompileOptions::analyzerThreads 大于 1 时并行检查
+ */
 class Analyzer : public Pass
 {
 public:
@@ -23,35 +34,122 @@ public:
 
     virtual void run() override;
 
-    // Visitor methods
-    void visit(std::unique_ptr<Program> program);
-    void visit(std::unique_ptr<StructDef> structDef);
-    void visit(std::unique_ptr<FunctionDef> funcDef);
-    void visit(std::unique_ptr<GlobalVarDef> globalVar);
-    void visit(std::unique_ptr<CompoundStmt> stmt);
-    void visit(std::unique_ptr<DeclStmt> decl);
-    void visit(std::unique_ptr<AssignStmt> assign);
-    void visit(std::unique_ptr<IfStmt> ifStmt);
-    void visit(std::unique_ptr<ReturnStmt> ret);
-    void visit(std::unique_ptr<WhileStmt> whileStmt);
-    void visit(std::unique_ptr<ForStmt> forStmt);
-    void visit(std::unique_ptr<ExprStmt> exprStmt);
-    void visit(std::unique_ptr<BinaryOp> binop);
-    void visit(std::unique_ptr<IdentifierExpr> ident);
-    void visit(std::unique_ptr<LiteralExpr> literal);
-    void visit(std::unique_ptr<FunctionCall> call);
-    void visit(std::unique_ptr<MemberAccess> access);
-    void visit(std::unique_ptr<StructInitExpr> init);
-    void visit(std::unique_ptr<CastExpr> cast);
-    void visit(std::unique_ptr<ParenExpr> paren);
-
 private:
-    SymbolTable symbolTable;
-    std::vector<std::string> errors;
-    std::shared_ptr<Type> currentType;
-    bool inGlobalScope = true;
-
-    bool typeCheck(std::shared_ptr<Type> expected, std::shared_ptr<Type> actual, const ASTNode &node);
-    bool isAssignable(std::shared_ptr<Type> target, std::shared_ptr<Type> source, const ASTNode &node);
-    std::shared_ptr<Type> getTypeFromExpr(Expr &expr);
+    // 全局作用域中的函数和全局变量，收集完全局声明后只读
+    SymbolTable globalScope;
+    // 函数体中的参数和局部变量，找不到的名字再到全局作用域中查找
+    SymbolTable localScopes;
+
+    // 持有全局声明的 Analyzer ，并行检查时工作线程中的 Analyzer 从这里读取全局作用域和成员函数
+    const Analyzer *declarations = this;
+
+    // 不为空时诊断信息先保存在这里，之后再按源代码顺序报告
+    std::vector<Diagnostic> *diagnosticBuffer = nullptr;
+
+    const NameId selfName = NameId::get("self");
+
+    // 所有类型由 Context 中的 TypeContext 创建，run 开始时设置
+    TypeContext *types = nullptr;
+
+    struct Method
+    {
+        const MemberFunctionDef *definition;
+        const SemanticType *type;
+    };
+
+    // 结构体的成员函数和它们的函数类型，键由结构体名和函数名的编号组成
+    std::unordered_map<uint64_t, Method> methods;
+
+    // 一个需要检查的函数体
+    struct FunctionBody
+    {
+        const ASTList<Param *> *params;
+        const SemanticType *type;
+        const Stmt *body;
+        const SelfParam *selfParam;
+        NameId structName;
+    };
+
+    // 正在检查的函数的返回类型，没有写出返回类型时是错误类型，不检查返回值
+    const SemanticType *currentReturnType = nullptr;
+
+    // checkBinaryOp 展开左侧的运算符链时使用的栈，所有调用共用，不需要每次分配
+    std::vector<const BinaryOp *> binaryChain;
+    // checkStructInit 记录成员是否已经初始化，同样在调用之间复用
+    std::vector<bool> initializedMembers;
+    // declareSignature 收集参数类型时使用
+    std::vector<const SemanticType *> signatureTypes;
+    // 正在计算布局的结构体，用来发现按值包含自己的结构体
+    std::vector<const SemanticType *> layoutStack;
+
+    void error(const ASTNode &node, std::string msg, size_t length = 1);
+
+    static inline uint64_t getMethodKey(NameId structName, NameId methodName)
+    {
+        return ((uint64_t)structName.id << 32) | methodName.id;
+    }
+
+    const Method *findMethod(NameId structName, NameId methodName) const;
+
+    // 先在局部作用域中查找，再查找全局作用域
+    const SymbolTable::Symbol *lookup(NameId name) const;
+
+    /* 声明 */
+    void declareGlobals(const Program &program);
+    // 计算结构体的布局，按值包含的结构体先计算
+    void declareStructLayout(const SemanticType *structType);
+    void declareGlobalVariable(const GlobalVarDef &var);
+    // 解析参数和返回类型，返回函数类型
+    const SemanticType *declareSignature(const ASTList<Param *> &params, const Type *returnType);
+    void declareParams(const ASTList<Param *> &params, std::span<const SemanticType *const> paramTypes);
+
+    /* 函数体 */
+
+    // 按源代码顺序收集所有函数和成员函数的函数体，重复定义的函数不检查
+    void collectFunctionBodies(const Program &program, std::vector<FunctionBody> &bodies) const;
+    // 把函数体按顺序分成多个分块，每个分块在线程池中由单独的 Analyzer 检查
+    void checkFunctionsInParallel(const std::vector<FunctionBody> &bodies, size_t threadCount);
+    void checkFunction(const FunctionBody &function);
+    void checkStmt(const Stmt &stmt);
+    void checkDeclStmt(const DeclStmt &decl);
+    void checkAssignStmt(const AssignStmt &assign);
+    void checkReturnStmt(const ReturnStmt &ret);
+    void checkCondition(const Expr &condition);
+
+    /* 表达式 */
+    const SemanticType *checkExpr(const Expr &expr);
+    const SemanticType *checkIdentifier(const IdentifierExpr &identifier);
+    const SemanticType *checkBinaryOp(const BinaryOp &binary);
+    const SemanticType *checkBinaryOperands(const BinaryOp &binary, const SemanticType *left, const SemanticType *right);
+    const SemanticType *checkUnaryOp(const UnaryOp &unary);
+    const SemanticType *checkCast(const CastExpr &castExpr);
+    const SemanticType *checkStructInit(const StructInitExpr &init);
+    const SemanticType *checkMemberAccess(const MemberAccess &access);
+    const SemanticType *checkFunctionCall(const FunctionCall &call);
+    // receiver 是调用成员函数的对象，静态调用时为 nullptr
+    const SemanticType *checkMethodCall(const ASTNode &call, const Expr *receiver, const SemanticType *receiverType, NameId structName, NameId methodName, const ASTList<Expr *> &arguments);
+    void checkArguments(const ASTNode &call, NameId calleeName, const ASTList<Param *> &params, std::span<const SemanticType *const> paramTypes, const ASTList<Expr *> &arguments);
+
+    /* 类型 */
+    const SemanticType *resolveType(const Type *type);
+
+    // 成员访问链最外层的变量，例如 a.b.c 中的 a ，表达式不是变量或者变量的成员时返回 nullptr
+    static const IdentifierExpr *getAccessRoot(const Expr &expr);
+
+    // 能否通过变量修改它的值，变量必须是 mut 的，变量是引用时还必须是 &mut
+    static bool isWritable(const SymbolTable::Symbol &symbol);
+
+    /**
+     * 按 &mut 传递或绑定的值必须来自可变的变量，否则可以绕过对不可变变量赋值的检查
+     * 值本身是引用时由 isAssignable 检查引用是否可变，临时值不检查
+     */
+    void expectMutableBinding(const Expr &value, const SemanticType *valueType, std::string_view what);
+
+    // source 能否隐式转换成 target ，引用和被引用的类型之间可以自动转换，但 &T 不能转换成 &mut T
+    static bool isAssignable(const SemanticType *target, const SemanticType *source);
+
+    // 两个操作数的公共类型，不存在时返回 nullptr
+    static const SemanticType *unify(const SemanticType *left, const SemanticType *right);
+
+    void expectAssignable(const ASTNode &node, const SemanticType *target, const SemanticType *source, std::string_view what);
 };
\ No newline at end of file
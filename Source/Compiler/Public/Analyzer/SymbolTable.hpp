@@ -1,19 +1,33 @@
 /**
  * Copyright 2025, LiserverYang. All rights reserved.
+ * 此文件定义了语义分析使用的符号表
  */
 
-#include <map>
-#include <memory>
-#include <stack>
-#include <string>
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
 #include <vector>
 
+#include "Analyzer/Types.hpp"
+#include "Core/StringInterner.hpp"
 #include "Parser/AST.hpp"
-#include "llvm/IR/Value.h"
 
+namespace llvm
+{
+class Value;
+}
+
+/**
+ * SymbolTable 是带作用域的符号表
+ * 所有作用域共用一个以 NameId 为键的开放寻址哈希表，每个槽位指向这个名字当前可见的符号，
+ * 被遮蔽的同名符号通过 shadowed 连成一条链，查找只需要一次哈希
+ * 符号按加入顺序保存在 entries 中，它同时也是撤销日志：退出作用域时从末尾弹出这个作用域的符号，并恢复被遮蔽的符号
+ */
 class SymbolTable
 {
-    enum class SymbolKind
+public:
+    enum class SymbolKind : uint8_t
     {
         VARIABLE,
         FUNCTION,
@@ -21,71 +35,89 @@ class SymbolTable
         PARAMETER
     };
 
+    /**
+     * 符号只引用声明它的 AST 节点，不复制参数列表和结构体成员
+     */
     struct Symbol
     {
-        SymbolKind kind;
-        std::string name;
-        std::shared_ptr<Type> type;
+        SymbolKind kind = SymbolKind::VARIABLE;
+        NameId name;
+
+        // 声明这个符号的节点，例如 DeclStmt 、 Param 、 FunctionDef 、 StructDef
+        const ASTNode *declaration = nullptr;
+        // 变量的类型，函数是函数类型
+        const SemanticType *type = nullptr;
+
         llvm::Value *llvmValue = nullptr;
         bool isMutable = false;
+        // 是否在全局作用域中，由 addSymbol 设置
         bool isGlobal = false;
-
-        // For functions
-        std::vector<std::shared_ptr<Type>> paramTypes;
-        std::shared_ptr<Type> returnType;
-
-        // For structs
-        std::vector<MemberVarDef> members;
     };
 
-    void enterScope()
-    {
-        scopes.push({});
-    }
+    // 创建时已经处于全局作用域中
+    SymbolTable();
 
-    void exitScope()
-    {
-        scopes.pop();
-    }
+    void enterScope();
 
-    bool addSymbol(const std::string &name, Symbol symbol)
-    {
-        if (scopes.top().count(name))
-            return false;
+    // 退出当前作用域，耗时只和这个作用域中的符号数量有关，不能退出全局作用域
+    void exitScope();
 
-        scopes.top()[name] = symbol;
-        return true;
+    // 全局作用域的深度为 1
+    inline size_t getScopeDepth() const
+    {
+        return scopeStarts.size();
     }
 
-    Symbol *lookup(const std::string &name);
-
-    Symbol *lookupCurrentScope(const std::string &name);
+    /**
+     * 在当前作用域中加入一个符号，当前作用域中已经有同名的符号时返回 false
+     * 外层作用域中的同名符号会被遮蔽，直到退出当前作用域
+     */
+    bool addSymbol(const Symbol &symbol);
+
+    /**
+     * 查找一个名字当前可见的符号，找不到时返回 nullptr
+     * 返回的指针在下一次 addSymbol 或 exitScope 之前有效
+     */
+    Symbol *lookup(NameId name);
+    // 只读的查找，多个线程可以同时查找一个不再修改的符号表
+    const Symbol *lookup(NameId name) const;
+    Symbol *lookupCurrentScope(NameId name);
+
+    // 结构体只能在全局定义，单独保存，不会和变量互相遮蔽
+    bool addStruct(const StructDef *structDef);
+    const StructDef *getStruct(NameId name) const;
 
-    void addStruct(const std::string &name, const std::vector<MemberVarDef> &members);
-    const StructDef *getStruct(const std::string &name) const;
+private:
+    static constexpr uint32_t NO_ENTRY = UINT32_MAX;
 
-    void setCurrentFunction(Symbol *func)
+    struct Entry
     {
-        currentFunction = func;
-    }
-    Symbol *getCurrentFunction() const
-    {
-        return currentFunction;
-    }
+        Symbol symbol;
+        // 被这个符号遮蔽的同名符号在 entries 中的下标
+        uint32_t shadowed = NO_ENTRY;
+        // 符号所在作用域的深度
+        uint32_t depth = 0;
+    };
 
-    void setCurrentStruct(Symbol *structSym)
+    struct Slot
     {
-        currentStruct = structSym;
-    }
-    Symbol *getCurrentStruct() const
-    {
-        return currentStruct;
-    }
+        NameId name;
+        // 这个名字当前可见的符号，没有可见的符号时为 NO_ENTRY ，名字本身仍然留在槽位中
+        uint32_t head = NO_ENTRY;
+    };
 
-private:
-    std::stack<std::map<std::string, Symbol>> scopes;
-    std::map<std::string, StructDef> structs;
+    // 开放寻址的哈希表，容量是 2 的幂，空槽位的 name 为空
+    std::vector<Slot> slots;
+    size_t usedSlots = 0;
+
+    std::vector<Entry> entries;
+    // 每个作用域的第一个符号在 entries 中的下标
+    std::vector<uint32_t> scopeStarts;
+
+    std::unordered_map<NameId, const StructDef *> structs;
 
-    Symbol *currentFunction = nullptr;
-    Symbol *currentStruct = nullptr;
+    // 找到名字所在的槽位，名字不在表中时返回它应该插入的空槽位
+    Slot &findSlot(NameId name);
+    const Slot &findSlot(NameId name) const;
+    void grow();
 };
\ No newline at end of file
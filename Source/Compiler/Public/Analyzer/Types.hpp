@@ -1,128 +1,324 @@
 /**
  * Copyright 2025, LiserverYang. All rights reserved.
+ * 此文件定义了语义分析使用的类型和创建它们的 TypeContext
  */
 
 #pragma once
 
-#include <memory>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <span>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
-#include "Lexer/Token.hpp"
-#include "Parser/AST.hpp"
-#include "llvm/IR/Type.h"
+#include "Core/StringInterner.hpp"
 
-class Type
+class StructDef;
+class StructLayout;
+
+/**
+ * SemanticType 是语义分析中表达式和符号的类型，和 AST 中写出的 Type 节点不同
+ * 类型只能由 TypeContext 创建，创建后不会修改，相同的类型只有一个对象
+ * 所以类型总是通过 const SemanticType * 传递，比较指针就能判断两个类型是否相同，也可以直接作为缓存的键
+ */
+class SemanticType
 {
 public:
-    enum class TypeKind
+    enum class Kind : uint8_t
     {
-        PRIMITIVE,
-        STRUCT,
-        FUNCTION,
-        VOID
+        Error,        // 未知的类型，或者已经报告过错误，和任何类型都兼容，避免一个错误引起更多的错误
+        Void,
+        IntLiteral,   // 还没有确定类型的整数字面量，可以隐式转换成任何整数或浮点类型
+        FloatLiteral, // 还没有确定类型的浮点字面量，可以隐式转换成任何浮点类型
+        String,
+
+        /* 基本类型，顺序和 TokenCode 中的类型关键字相同 */
+        I8,
+        I16,
+        I32,
+        I64,
+        F32,
+        F64,
+        Bool,
+        Char,
+
+        Struct,
+        Reference,
+        Function
     };
 
-    Type(TypeKind kind, const std::string &name)
-        : kind(kind), typeName(name) {}
+    // 只有 TypeContext 能创建这个参数，所以类型只能通过 TypeContext 创建
+    class CreationKey
+    {
+        friend class TypeContext;
+        CreationKey() = default;
+    };
 
-    virtual ~Type() = default;
+    SemanticType(CreationKey, Kind kind) : kind(kind) {}
 
-    bool isPrimitive() const
+    SemanticType(const SemanticType &) = delete;
+    SemanticType &operator=(const SemanticType &) = delete;
+
+    inline Kind getKind() const
     {
-        return kind == TypeKind::PRIMITIVE;
+        return kind;
     }
-    bool isStruct() const
+
+    inline bool isError() const
     {
-        return kind == TypeKind::STRUCT;
+        return kind == Kind::Error;
     }
-    bool isFunction() const
+
+    inline bool isVoid() const
     {
-        return kind == TypeKind::FUNCTION;
+        return kind == Kind::Void;
     }
-    bool isVoid() const
+
+    inline bool isBool() const
     {
-        return kind == TypeKind::VOID;
+        return kind == Kind::Bool;
     }
 
-    const std::string &getName() const
+    inline bool isChar() const
     {
-        return typeName;
+        return kind == Kind::Char;
     }
-    TypeKind getKind() const
+
+    inline bool isInteger() const
     {
-        return kind;
+        return kind == Kind::IntLiteral || (kind >= Kind::I8 && kind <= Kind::I64);
     }
 
-    virtual llvm::Type *toLLVMType(llvm::LLVMContext &context) const = 0;
+    inline bool isFloat() const
+    {
+        return kind == Kind::FloatLiteral || kind == Kind::F32 || kind == Kind::F64;
+    }
 
-    static std::shared_ptr<Type> fromToken(const Token &token);
-    static std::shared_ptr<Type> getVoidType();
+    inline bool isNumeric() const
+    {
+        return isInteger() || isFloat();
+    }
 
-private:
-    TypeKind kind;
-    std::string typeName;
-};
+    inline bool isStruct() const
+    {
+        return kind == Kind::Struct;
+    }
 
-class PrimitiveType : public Type
-{
-public:
-    PrimitiveType(const std::string &name)
-        : Type(TypeKind::PRIMITIVE, name) {}
+    inline bool isReference() const
+    {
+        return kind == Kind::Reference;
+    }
 
-    llvm::Type *toLLVMType(llvm::LLVMContext &context) const override;
-};
+    inline bool isFunction() const
+    {
+        return kind == Kind::Function;
+    }
 
-class StructType : public Type
-{
-public:
-    StructType(const std::string &name, const std::vector<MemberVarDef> &members)
-        : Type(TypeKind::STRUCT, name), members(members) {}
+    // 引用类型是否是 &mut
+    inline bool isMutReference() const
+    {
+        return kind == Kind::Reference && mutableReference;
+    }
+
+    // 去掉引用之后的类型，不是引用时返回自己
+    inline const SemanticType *withoutReference() const
+    {
+        return kind == Kind::Reference ? element : this;
+    }
 
-    llvm::Type *toLLVMType(llvm::LLVMContext &context) const override;
+    // 引用指向的类型
+    inline const SemanticType *getPointee() const
+    {
+        return kind == Kind::Reference ? element : nullptr;
+    }
+
+    // 结构体的名字
+    inline NameId getName() const
+    {
+        return name;
+    }
+
+    // 定义结构体的节点
+    inline const StructDef *getStructDef() const
+    {
+        return structDef;
+    }
+
+    // 结构体的布局，收集全局声明时由 TypeContext::createStructLayout 设置，之前为 nullptr
+    inline const StructLayout *getLayout() const
+    {
+        return layout;
+    }
+
+    // 函数的返回类型和参数类型
+    inline const SemanticType *getReturnType() const
+    {
+        return kind == Kind::Function ? element : nullptr;
+    }
 
-    const std::vector<MemberVarDef> &getMembers() const
+    inline std::span<const SemanticType *const> getParamTypes() const
     {
-        return members;
+        return paramTypes;
     }
-    int getMemberIndex(const std::string &name) const;
+
+    std::string toString() const;
 
 private:
-    std::vector<MemberVarDef> members;
+    friend class TypeContext;
+
+    Kind kind;
+    bool mutableReference = false;
+    NameId name;
+    const StructDef *structDef = nullptr;
+    const StructLayout *layout = nullptr;
+
+    // 引用指向的类型，或者函数的返回类型
+    const SemanticType *element = nullptr;
+    std::vector<const SemanticType *> paramTypes;
 };
 
-class FunctionType : public Type
+/**
+ * StructLayout 是一个结构体的成员类型、偏移、对齐和大小，每个结构体只计算一次
+ * 成员按定义的顺序排列，按 C 的规则对齐，Analyzer 检查成员访问和代码生成计算成员地址时都使用这里的下标
+ * 成员名到下标的映射是一个开放寻址的哈希表，成员很多的结构体查找成员也只需要一次哈希
+ */
+class StructLayout
 {
 public:
-    FunctionType(std::shared_ptr<Type> returnType,
-        const std::vector<std::shared_ptr<Type>> &paramTypes)
-        : Type(TypeKind::FUNCTION, "function"),
-          returnType(returnType),
-          paramTypes(paramTypes) {}
+    static constexpr uint32_t NO_MEMBER = UINT32_MAX;
 
-    llvm::Type *toLLVMType(llvm::LLVMContext &context) const override;
+    struct Member
+    {
+        NameId name;
+        const SemanticType *type = nullptr;
+        uint64_t offset = 0;
+    };
 
-    std::shared_ptr<Type> getReturnType() const
+    inline size_t getMemberCount() const
     {
-        return returnType;
+        return members.size();
     }
-    const std::vector<std::shared_ptr<Type>> &getParamTypes() const
+
+    inline const Member &getMember(uint32_t index) const
     {
-        return paramTypes;
+        return members[index];
+    }
+
+    inline uint64_t getSize() const
+    {
+        return size;
     }
 
+    inline uint64_t getAlignment() const
+    {
+        return alignment;
+    }
+
+    // 成员名对应的下标，没有这个成员时返回 NO_MEMBER
+    uint32_t getMemberIndex(NameId name) const;
+
 private:
-    std::shared_ptr<Type> returnType;
-    std::vector<std::shared_ptr<Type>> paramTypes;
+    friend class TypeContext;
+
+    std::vector<Member> members;
+    uint64_t size = 0;
+    uint64_t alignment = 1;
+
+    // 槽位中存放成员的下标，空槽位为 NO_MEMBER ，容量是 2 的幂
+    std::vector<uint32_t> memberSlots;
 };
 
-class VoidType : public Type
+/**
+ * TypeContext 持有所有的 SemanticType ，由 Context 持有，Analyzer 和代码生成共享同一个 TypeContext
+ * 基本类型在创建 TypeContext 时就已经存在，结构体按名字唯一，引用和函数类型按组成它们的类型指针做哈希唯一化
+ * 类型在 TypeContext 析构之前一直有效
+ * 结构体和它们的布局只在收集全局声明时创建，之后多个线程可以同时查找类型，以及创建引用和函数类型
+ */
+class TypeContext
 {
 public:
-    VoidType() : Type(TypeKind::VOID, "void") {}
+    TypeContext();
+
+    TypeContext(const TypeContext &) = delete;
+    TypeContext &operator=(const TypeContext &) = delete;
+
+    inline const SemanticType *getErrorType() const
+    {
+        return getBuiltin(SemanticType::Kind::Error);
+    }
 
-    llvm::Type *toLLVMType(llvm::LLVMContext &context) const override
+    inline const SemanticType *getVoidType() const
     {
-        return llvm::Type::getVoidTy(context);
+        return getBuiltin(SemanticType::Kind::Void);
     }
+
+    inline const SemanticType *getBoolType() const
+    {
+        return getBuiltin(SemanticType::Kind::Bool);
+    }
+
+    inline const SemanticType *getCharType() const
+    {
+        return getBuiltin(SemanticType::Kind::Char);
+    }
+
+    // 除结构体、引用和函数之外的类型
+    inline const SemanticType *getBuiltin(SemanticType::Kind kind) const
+    {
+        return builtins[static_cast<size_t>(kind)];
+    }
+
+    // 基本类型的名字对应的类型，名字不是基本类型时返回 nullptr
+    const SemanticType *getPrimitive(NameId name) const;
+
+    /**
+     * 为结构体定义创建类型，已经有同名的结构体时返回 nullptr
+     * 结构体只能在全局定义，所以名字就能确定一个结构体
+     */
+    const SemanticType *createStructType(const StructDef *structDef);
+
+    // 名字对应的结构体类型，没有定义时返回 nullptr
+    const SemanticType *getStructType(NameId name) const;
+
+    /**
+     * 计算结构体的布局并保存在结构体类型中，memberTypes 和 StructDef 中的成员一一对应
+     * 按值包含的结构体成员必须已经有布局，同名的成员只保留第一个的下标
+     */
+    const StructLayout *createStructLayout(const SemanticType *structType, std::span<const SemanticType *const> memberTypes);
+
+    // 类型按值存储时的大小和对齐
+    static uint64_t getSizeOf(const SemanticType *type);
+    static uint64_t getAlignmentOf(const SemanticType *type);
+
+    // 引用的引用和引用本身相同
+    const SemanticType *getReferenceType(const SemanticType *pointee, bool isMutable);
+
+    const SemanticType *getFunctionType(const SemanticType *returnType, std::span<const SemanticType *const> paramTypes);
+
+    // 字面量的默认类型，整数是 i32 ，浮点数是 f64 ，其它类型不变
+    const SemanticType *concretize(const SemanticType *type) const;
+
+private:
+    // 所有类型的存储，deque 保证添加新的类型时已有的类型不会移动
+    std::deque<SemanticType> types;
+    std::deque<StructLayout> layouts;
+
+    std::array<const SemanticType *, static_cast<size_t>(SemanticType::Kind::Char) + 1> builtins{};
+
+    std::unordered_map<NameId, const SemanticType *> primitivesByName;
+    std::unordered_map<NameId, SemanticType *> structs;
+
+    // 键是指向的类型和是否可变
+    std::unordered_map<uintptr_t, const SemanticType *> references;
+
+    // 相同哈希值的函数类型可能不同，需要逐个比较
+    std::unordered_multimap<size_t, const SemanticType *> functions;
+
+    // 保护 types 、 references 和 functions ，并行检查函数体时仍然可能创建新的引用类型
+    std::mutex mutex;
+
+    SemanticType &create(SemanticType::Kind kind);
 };
\ No newline at end of file
@@ -4,8 +4,74 @@
 
 #pragma once
 
+#include "Analyzer/Types.hpp"
+#include "Core/Diagnostics.hpp"
+#include "Core/LineTable.hpp"
+#include "Core/SourceManager.hpp"
 #include "Lexer/Token.hpp"
-#include "Parser/AST.hpp"
+#include "Parser/ASTContext.hpp"
+#include "Parser/FlatAST.hpp"
+
+#include <deque>
+#include <string_view>
+
+/**
+ * CompileOptions 存储了控制编译流程的选项
+ */
+struct CompileOptions
+{
+    /**
+     * 为 true 时不再单独运行 Lexer 生成完整的 TokenStream
+     * Parser 通过 TokenCursor 按需从 Lexer 拉取 Token ，内存占用只和向前看的距离有关
+     */
+    bool streamingLexer = false;
+
+    /**
+     * Lexer 使用的线程数量，大于 1 时较大的源文件会被切分成多个分块并行解析
+     */
+    size_t lexerThreads = 1;
+
+    /**
+     * 并行解析时每个分块的最小字节数，源文件小于两个分块时不会并行
+     */
+    size_t lexerChunkSize = 256 * 1024;
+
+    /**
+     * 为 true 时 Parser 在解析完每个全局语句后，同时把它追加到 Context::flatAST 中
+     */
+    bool buildFlatAST = false;
+
+    /**
+     * Parser 允许的最大嵌套深度，嵌套的语句、括号、前缀运算符和函数调用参数各算一层
+     * 超过时报告错误而不是耗尽调用栈，之后的 Pass 也会递归遍历 AST ，所以默认值不宜过大
+     */
+    size_t maxNestingDepth = 1024;
+
+    /**
+     * 为 true 时 Parser 先只解析全局声明和函数签名，函数体通过括号匹配跳过，之后只解析从 main 可能调用到的函数体
+     * 其它函数体可以通过 Parser::parseBody 按需解析，其中的错误在解析时才会报告
+     * 延迟解析需要回到之前的 Token ，所以和 streamingLexer 同时使用时不生效
+     */
+    bool lazyFunctionBodies = false;
+
+    /**
+     * Parser 使用的线程数量，大于 1 时先解析全局声明和函数签名，再把函数体分成多个分块并行解析
+     * 所有结构体在解析函数体之前就已经知道，诊断信息按位置排序后报告
+     * 和 streamingLexer 同时使用时不生效，和 lazyFunctionBodies 同时使用时只按需解析函数体
+     */
+    size_t parserThreads = 1;
+
+    /**
+     * Analyzer 使用的线程数量，大于 1 时先收集全局声明，再把函数体分成多个分块并行检查
+     * 诊断信息按函数在源代码中的顺序报告，和单线程检查的结果相同
+     */
+    size_t analyzerThreads = 1;
+
+    /**
+     * 为 true 时只做词法和语法分析，不运行 Analyzer ，例如只需要 AST 的工具或者测试
+     */
+    bool syntaxOnly = false;
+};
 
 /**
  * Context 存储了所有有关于编译的信息，这些信息在不同的 Pass 之间共享
@@ -13,16 +79,146 @@
 struct Context
 {
     std::string filePath;
-    std::string fileValue;
+
+    CompileOptions options;
+
+    /**
+     * 持有所有加载过的源文件
+     */
+    SourceManager sourceManager;
+
+    /**
+     * 正在编译的源文件的编号和内容，内容由 sourceManager 持有，结尾之后一定有 '\0'
+     */
+    uint16_t fileId = 0;
+    std::string_view fileValue;
+
+    /**
+     * 源文件的行首表，第一次调用 getLocation 时才会构建
+     */
+    LineTable lineTable;
 
     /**
      * 当源文件被 Lexer 解析后，就会得到 TokenStream
+     * 流式模式下 Token 不会保存在这里
      */
     TokenStream tokenStream;
 
+    /**
+     * 编译过程中报告的可以恢复的错误和警告
+     */
+    DiagnosticEngine diagnostics;
+
+    /**
+     * 经过转义处理后和源代码不同的字面量值，例如 "a\\n" 的值是 a 加上换行符
+     * 使用 std::deque 保证添加新的值时已有的值不会移动
+     */
+    std::deque<std::string> literalPool;
+
+    /**
+     * 所有 AST 节点所在的内存池，Context 析构时整个 AST 一次性释放
+     */
+    ASTContext astContext;
+
     /**
      * Parser 通过解析 TokenStream 得到抽象语法树（AST）
      * Program 可以认为是 AST 的根节点
      */
     Program program;
+
+    /**
+     * AST 的扁平表示，只有 options.buildFlatAST 为 true 时才会生成
+     * 它不引用 astContext 中的任何节点，可以在 AST 释放之后继续使用
+     */
+    FlatAST flatAST;
+
+    /**
+     * 语义分析得到的所有类型，同一个类型只有一个对象，之后的代码生成也使用这里的类型
+     */
+    TypeContext typeContext;
+
+    /**
+     * 通过 sourceManager 加载 filePath 指向的源文件，失败时返回 false
+     */
+    bool loadSource()
+    {
+        std::optional<uint16_t> id = sourceManager.loadFile(filePath);
+
+        if (!id)
+        {
+            return false;
+        }
+
+        useSource(*id);
+        return true;
+    }
+
+    /**
+     * 直接使用一段已经在内存中的代码作为源文件，代码会被复制一份
+     */
+    void setSource(std::string_view code)
+    {
+        useSource(sourceManager.addBuffer(filePath, code));
+    }
+
+    /**
+     * 获取 Token 的值
+     * 字符串和字符字面量的值不包括两侧的引号，如果有转义则从 literalPool 中获取
+     * 返回的 string_view 指向 fileValue 或 literalPool ，不会复制
+     */
+    std::string_view getTokenValue(const Token &token) const
+    {
+        if (token.hasLiteral())
+        {
+            return literalPool[token.literalIndex];
+        }
+
+        std::string_view source = fileValue;
+
+        if (token.code == TokenCode::STRING_LITERAL || token.code == TokenCode::CHAR_LITERAL)
+        {
+            return source.substr(token.offset + 1, token.length - 2);
+        }
+
+        return source.substr(token.offset, token.length);
+    }
+
+    /**
+     * 获取字面量节点的值，和 getTokenValue 得到的字面量 Token 的值相同
+     */
+    std::string_view getLiteralValue(const LiteralExpr &literal) const
+    {
+        if (literal.literalIndex != Token::NO_LITERAL)
+        {
+            return literalPool[literal.literalIndex];
+        }
+
+        // 字符串和字符字面量不包括两侧的引号
+        const uint32_t quote = literal.type == LiteralExpr::LiteralType::String || literal.type == LiteralExpr::LiteralType::Char;
+        return fileValue.substr(literal.offset + quote, literal.length - quote * 2);
+    }
+
+    /**
+     * 报告源文件中 [position, position + length) 处的一条诊断信息，错误不会终止编译
+     */
+    void report(Logger::LogLevel level, std::string msg, size_t position, size_t length)
+    {
+        diagnostics.report(level, {fileValue, filePath, std::move(msg), position, length, &lineTable});
+    }
+
+    /**
+     * 获取源文件中下标对应的行列信息
+     */
+    SourceLocation getLocation(size_t offset)
+    {
+        return lineTable.getLocation(fileValue, offset);
+    }
+
+private:
+    void useSource(uint16_t id)
+    {
+        fileId = id;
+        fileValue = sourceManager.getFile(id).content;
+        lineTable = LineTable();
+    }
 };
\ No newline at end of file
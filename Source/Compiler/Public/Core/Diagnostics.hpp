@@ -0,0 +1,51 @@
+/**
+ * Copyright 2025, LiserverYang. All rights reserved.
+ * 此文件定义了收集编译过程中诊断信息的 DiagnosticEngine
+ */
+
+#pragma once
+
+#include "Logger/Logger.hpp"
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * 一条诊断信息，只记录出错位置的下标
+ */
+struct Diagnostic
+{
+    Logger::LogLevel level;
+    std::string msg;
+    size_t position;
+    size_t length;
+};
+
+/**
+ * DiagnosticEngine 收集可以恢复的错误和警告，由 Context 持有
+ * 每条诊断信息在报告时立即输出，编译不会因为一个错误而终止，调用者通过 hasErrors 决定是否继续后续的 Pass
+ * 多个线程可以同时报告
+ */
+class DiagnosticEngine
+{
+public:
+    void report(Logger::LogLevel level, const Logger::LogInfo &info);
+
+    size_t getErrorCount() const;
+
+    inline bool hasErrors() const
+    {
+        return getErrorCount() != 0;
+    }
+
+    // 按报告顺序返回所有诊断信息的副本
+    std::vector<Diagnostic> getDiagnostics() const;
+
+private:
+    mutable std::mutex mutex;
+
+    std::vector<Diagnostic> diagnostics;
+    size_t errorCount = 0;
+};
\ No newline at end of file
@@ -0,0 +1,48 @@
+/**
+ * Copyright 2025, LiserverYang. All rights reserved.
+ * 此文件定义了行首表，用于把源代码中的下标转换为行列信息
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * SourceLocation 是一个下标在源代码中对应的行列，行号和列号都从 1 开始
+ */
+struct SourceLocation
+{
+    size_t line = 0, col = 0;
+    // 所在行的起始下标
+    size_t lineStart = 0;
+};
+
+/**
+ * LineTable 记录了一个源文件中每一行的起始下标
+ * Token 和 AST 节点只保存下标，只有在需要输出行列信息时（例如报错）才会构建这个表
+ * 之后每次查询都通过二分查找完成
+ */
+class LineTable
+{
+public:
+    // 根据源代码构建行首表，已经构建过时会重新构建
+    void build(std::string_view source);
+
+    bool isBuilt() const
+    {
+        return !lineStarts.empty();
+    }
+
+    // 获取下标对应的行列，如果还没有构建则先构建
+    SourceLocation getLocation(std::string_view source, size_t offset);
+
+    size_t getLineCount() const
+    {
+        return lineStarts.size();
+    }
+
+private:
+    std::vector<uint32_t> lineStarts;
+};
\ No newline at end of file
@@ -28,6 +28,12 @@ public:
         for (auto &pass : passes)
         {
             pass->run();
+
+            // 之前的 Pass 报告了错误时，后面的 Pass 拿到的数据可能不完整
+            if (context->diagnostics.hasErrors())
+            {
+                break;
+            }
         }
     }
 };
\ No newline at end of file
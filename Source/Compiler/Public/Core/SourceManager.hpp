@@ -0,0 +1,85 @@
+/**
+ * Copyright 2025, LiserverYang. All rights reserved.
+ * 此文件定义了 SourceManager ，用于加载和保存源文件
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * SourceFile 是一个已经加载到内存中的源文件
+ * 文件内容优先通过 mmap 只读映射，无法映射时一次性读入预先分配好大小的缓冲区
+ * 无论哪种方式，content 之后都至少有 PADDING_SIZE 个 '\0' ，词法分析器可以把它当作结束标记
+ */
+class SourceFile
+{
+public:
+    // content 之后保证存在的 '\0' 的数量
+    // 除了一个结束标记之外，还留出了一个 AVX-512 向量的宽度，向量化的扫描可以越过结尾读取而不会访问到无效内存
+    static constexpr size_t PADDING_SIZE = 1 + 64;
+
+    SourceFile() = default;
+    ~SourceFile();
+
+    SourceFile(const SourceFile &) = delete;
+    SourceFile &operator=(const SourceFile &) = delete;
+
+    std::string path;
+
+    // 文件的内容，不包括结尾的 '\0'
+    std::string_view content;
+
+    // 通过 mmap 映射文件，文件为空或者页末尾没有足够的空间放下结尾的 '\0' 时会失败
+    bool map();
+    // 把文件读入 storage
+    bool read();
+    // 复制一段已经在内存中的代码
+    void assign(std::string_view code);
+
+private:
+    // mmap 映射的内存，为 nullptr 时表示内容保存在 storage 中
+    void *mapping = nullptr;
+    size_t mappingSize = 0;
+
+    std::unique_ptr<char[]> storage;
+};
+
+/**
+ * SourceManager 持有编译过程中用到的所有源文件，通过 Token::fileId 可以找到 Token 所在的文件
+ * 文件被加载后地址不会再改变，所以可以放心地保存指向文件内容的 string_view
+ */
+class SourceManager
+{
+public:
+    /**
+     * 加载一个源文件，返回它的编号
+     * 文件不存在或者无法读取时返回 std::nullopt
+     */
+    std::optional<uint16_t> loadFile(const std::string &path);
+
+    /**
+     * 添加一段已经在内存中的代码，例如测试用例，代码会被复制一份
+     */
+    uint16_t addBuffer(const std::string &path, std::string_view code);
+
+    inline SourceFile &getFile(uint16_t id)
+    {
+        return *files.at(id);
+    }
+
+    inline size_t getFileCount() const
+    {
+        return files.size();
+    }
+
+private:
+    std::vector<std::unique_ptr<SourceFile>> files;
+
+    uint16_t addFile(std::unique_ptr<SourceFile> file);
+};
\ No newline at end of file
@@ -0,0 +1,139 @@
+/**
+ * Copyright 2025, LiserverYang. All rights reserved.
+ * 此文件定义了全局的字符串驻留表和名字编号 NameId
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * NameId 是一个驻留过的名字（标识符、类型名等）的 32 位编号
+ * 相同的字符串总是得到相同的编号，所以比较名字只需要比较整数
+ * 编号 0 表示空字符串，也是默认值
+ */
+struct NameId
+{
+    uint32_t id = 0;
+
+    NameId() = default;
+    explicit NameId(uint32_t id) : id(id) {}
+
+    // 驻留一个字符串并返回它的编号
+    static NameId get(std::string_view text);
+
+    // 获取编号对应的字符串，返回的 string_view 在整个程序运行期间都有效
+    std::string_view str() const;
+
+    inline bool empty() const
+    {
+        return id == 0;
+    }
+
+    /**
+     * 给以 NameId 为键的开放寻址哈希表使用的哈希值，表的容量是 2 的幂，用低位作为槽位下标
+     * 编号的低位表示驻留表的分片，先用乘法哈希打散，再把高位混合进低位
+     */
+    inline uint32_t hash() const
+    {
+        const uint32_t mixed = id * 2654435769u;
+        return mixed ^ (mixed >> 16);
+    }
+
+    bool operator==(const NameId &) const = default;
+};
+
+template <>
+struct std::hash<NameId>
+{
+    size_t operator()(NameId name) const noexcept
+    {
+        return name.id;
+    }
+};
+
+inline std::ostream &operator<<(std::ostream &os, NameId name)
+{
+    return os << name.str();
+}
+
+/**
+ * StringInterner 是全局唯一的字符串驻留表，Lexer 、Parser 和 Analyzer 共享同一张表
+ * 字符串被复制到只增不减的内存块中，编号和字符串在程序结束前都不会失效
+ * 表被分成多个分片，每个分片有自己的锁，并行的 Lexer 可以同时驻留不同的名字
+ * 每个字符串只计算一次哈希，哈希值同时决定分片和分片内的槽位
+ */
+class StringInterner
+{
+public:
+    static StringInterner &getInstance();
+
+    NameId intern(std::string_view text);
+    std::string_view lookup(NameId name) const;
+
+    // 已经驻留的字符串数量，不包括空字符串
+    size_t size() const;
+
+private:
+    StringInterner() = default;
+
+    static constexpr uint32_t SHARD_BITS = 4;
+    static constexpr uint32_t SHARD_COUNT = 1u << SHARD_BITS;
+
+    // 每个分片的字符串按编号存放在固定大小的块中，块一旦分配就不会移动，读取时不需要加锁
+    static constexpr uint32_t BLOCK_BITS = 12;
+    static constexpr uint32_t BLOCK_SIZE = 1u << BLOCK_BITS;
+    static constexpr uint32_t MAX_BLOCKS = 1024;
+
+    // 字符串内容所在的内存块大小
+    static constexpr size_t ARENA_BLOCK_SIZE = 64 * 1024;
+
+    struct Entry
+    {
+        std::string_view text;
+        uint32_t hash = 0;
+    };
+
+    struct Shard
+    {
+        mutable std::mutex mutex;
+
+        std::array<std::unique_ptr<Entry[]>, MAX_BLOCKS> blocks;
+        uint32_t count = 0;
+
+        // 开放寻址的哈希表，存放分片内的下标加一，0 表示空槽位
+        std::vector<uint32_t> table;
+
+        std::vector<std::unique_ptr<char[]>> arena;
+        char *arenaCursor = nullptr;
+        size_t arenaLeft = 0;
+
+        const Entry &getEntry(uint32_t index) const
+        {
+            return blocks[index >> BLOCK_BITS][index & (BLOCK_SIZE - 1)];
+        }
+
+        std::string_view store(std::string_view text);
+        void grow();
+    };
+
+    std::array<Shard, SHARD_COUNT> shards;
+};
+
+inline NameId NameId::get(std::string_view text)
+{
+    return StringInterner::getInstance().intern(text);
+}
+
+inline std::string_view NameId::str() const
+{
+    return StringInterner::getInstance().lookup(*this);
+}
\ No newline at end of file
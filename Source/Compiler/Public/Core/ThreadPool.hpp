@@ -0,0 +1,52 @@
+/**
+ * Copyright 2025, LiserverYang. All rights reserved.
+ * 此文件定义了编译器内部使用的线程池
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * ThreadPool 持有固定数量的工作线程，按提交的顺序执行任务
+ * 任务不应该抛出异常，需要报告失败的任务应该自己捕获异常并记录结果
+ */
+class ThreadPool
+{
+public:
+    explicit ThreadPool(size_t threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // 提交一个任务
+    void submit(std::function<void()> task);
+
+    // 等待所有已经提交的任务执行完成
+    void wait();
+
+    inline size_t getThreadCount() const
+    {
+        return workers.size();
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable tasksFinished;
+
+    // 已经提交但还没有执行完的任务数量
+    size_t pendingTasks = 0;
+    bool stopping = false;
+
+    void workerLoop();
+};
\ No newline at end of file
@@ -8,10 +8,12 @@
 #include "Core/Pass.hpp"
 #include "Token.hpp"
 
-#include <cctype>
+#include <deque>
 #include <stdexcept>
 #include <memory>
 
+struct LocalNameTable;
+
 class Lexer : public Pass
 {
 public:
@@ -25,11 +27,54 @@ public:
 
     virtual void run() override;
 
+    /**
+     * 跳过空白和注释，解析下一个 Token
+     * 到达文件结尾时返回 false ，用于按需拉取 Token 的流式模式
+     */
+    bool lexNext(Token &token);
+
 private:
-    size_t index = 0;
-    size_t line = 1;
-    size_t column = 1;
-    size_t lineStart = 0;
+    /**
+     * Lexer 直接用指针遍历 context->fileValue ，[begin, end) 是源代码
+     * 源代码必须由 SourceManager 提供，保证 end 之后有 '\0' 作为结束标记
+     */
+    const char *begin = nullptr;
+    const char *cursor = nullptr;
+    const char *end = nullptr;
+
+    // 当前 Token 的起始位置
+    const char *tokenBegin = nullptr;
+
+    // 转义后的字面量保存的位置，默认是 context->literalPool ，并行解析时每个分块使用自己的
+    std::deque<std::string> *literalPool = nullptr;
+
+    // 并行解析时分块的名字表，不为空时标识符先不驻留，nameId 是名字在这张表中的下标
+    LocalNameTable *localNames = nullptr;
+
+    // 推测模式下遇到错误不会输出，而是抛出异常让调用者放弃这次推测
+    bool speculative = false;
+
+    void resetCursor();
+    void logError(std::string msg, size_t position);
+
+    /**
+     * 从当前位置开始解析，直到遇到第一个起始位置不小于 limit 的 Token 或者文件结尾
+     * 这个 Token 不会被保存，返回它的起始位置，也就是下一次解析应该开始的位置
+     */
+    size_t lexUntil(size_t limit, TokenStream &tokens);
+
+    /**
+     * 把源代码按行切分成多个分块，在线程池中推测地并行解析，再按顺序拼接
+     * 推测失败的分块会从正确的位置重新顺序解析，结果和顺序解析完全相同
+     * 名字在拼接时按源代码的顺序驻留，NameId 的编号也和顺序解析相同，不受线程调度的影响
+     */
+    void runParallel(size_t threadCount);
+
+    // 在当前位置创建一个 Token
+    Token beginToken(TokenCode code);
+    // 根据当前位置确定 Token 的长度，value 不为空时表示经过转义处理的字面量值
+    void finishToken(Token &token, const std::string *value = nullptr);
+
     void skipWhitespace();
     void skipLineComment();
     void skipBlockComment();
@@ -0,0 +1,35 @@
+/**
+ * Copyright 2025, LiserverYang. All rights reserved.
+ * 此文件定义了词法分析器使用的快速扫描函数
+ */
+
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Scanner 提供了一组在一段字节中查找特定字符的函数
+ * 每个函数都有 AVX2 、 SSE2 和标量三种实现，第一次调用时会根据 CPU 支持的指令集选择最快的实现
+ * 所有函数都只读取 [begin, end) 范围内的字节，找不到时返回 end
+ */
+class Scanner
+{
+public:
+    // 查找第一个不是空白字符（' ' '\t' '\n' '\v' '\f' '\r'）的位置
+    static const char *findNonWhitespace(const char *begin, const char *end);
+
+    // 查找第一个等于 c 的位置
+    static const char *findByte(const char *begin, const char *end, char c);
+
+    // 查找块注释的结束标记 "*/" ，返回其中 '*' 的位置
+    static const char *findBlockCommentEnd(const char *begin, const char *end);
+
+    // 查找字符串字面量中第一个需要特殊处理的字符，也就是 '"' 或 '\\'
+    static const char *findStringSpecial(const char *begin, const char *end);
+
+    // 统计 '\n' 的个数
+    static size_t countNewlines(const char *begin, const char *end);
+
+    // 当前使用的实现的名字，用于调试和测试
+    static const char *getImplementationName();
+};
\ No newline at end of file
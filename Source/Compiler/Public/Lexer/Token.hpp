@@ -6,16 +6,17 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <optional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
 /**
  * TokenCode 用来定义 Token 的类型
  * 对于不同类型的 Token ，我们可以定义不同的 TokenCode ，方便后续分析
  */
-enum class TokenCode
+enum class TokenCode : uint8_t
 {
     /* 未定义 */
     UNDEFINED,
@@ -97,12 +98,15 @@ enum class TokenCode
 // 所有关键字的长度
 const size_t KEYWORDS_LENGTH = (size_t)TokenCode::BOOLEAN_FALSE - (size_t)TokenCode::IMPT + 1;
 
+// 最长的关键字的长度，更长的标识符不需要查表
+const size_t MAX_KEYWORD_SIZE = 6;
+
 // 所有类型关键字长度
 const size_t TYPE_KEYWORD_BEGIN = (size_t)TokenCode::I8;
 const size_t TYPE_KEYWORD_END = (size_t)TokenCode::CHAR;
 
 // 所有关键字的对应字符串
-const std::array<std::string, KEYWORDS_LENGTH> keywords = {
+constexpr std::array<std::string_view, KEYWORDS_LENGTH> keywords = {
     "impt",
     "struct",
     "impl",
@@ -130,11 +134,93 @@ const std::array<std::string, KEYWORDS_LENGTH> keywords = {
     "true",
     "false"};
 
-// 初始化哈希表的函数
-std::unordered_map<std::string, size_t> buildKeywordIndexMap();
+/**
+ * 关键字的完美哈希
+ * 只用标识符的长度、首字符和尾字符计算哈希值，和一个在编译期搜索出来的种子混合后取高位作为槽位
+ * 种子保证所有关键字落在不同的槽位上，所以查询时只需要算一次哈希并比较一次字符串
+ * 整张表在编译期生成，不需要任何静态初始化
+ */
+namespace KeywordHash
+{
+// 哈希表的槽位数量的对数，槽位数量必须是 2 的幂
+constexpr uint32_t TABLE_BITS = 6;
+constexpr uint32_t TABLE_SIZE = 1u << TABLE_BITS;
+
+// 空槽位的标记
+constexpr uint8_t EMPTY_SLOT = UINT8_MAX;
+
+static_assert(KEYWORDS_LENGTH < TABLE_SIZE, "Keyword hash table is too small");
+
+// 计算标识符在给定种子下的槽位，调用者保证 text 非空
+constexpr uint32_t slotOf(std::string_view text, uint32_t seed)
+{
+    const uint32_t key = (uint32_t)(unsigned char)text.front() | (uint32_t)(unsigned char)text.back() << 8 | (uint32_t)text.size() << 16;
+
+    // 乘法之后再混合一次，让长度和首尾字符都能影响到高位
+    uint32_t hash = key * seed;
+    hash ^= hash >> 15;
+    hash *= 0x2c1b3c6du;
+    return hash >> (32 - TABLE_BITS);
+}
+
+// 判断种子能否让所有关键字落在不同的槽位上
+constexpr bool isPerfectSeed(uint32_t seed)
+{
+    std::array<bool, TABLE_SIZE> used{};
+
+    for (std::string_view keyword : keywords)
+    {
+        const uint32_t slot = slotOf(keyword, seed);
+
+        if (used[slot])
+        {
+            return false;
+        }
+
+        used[slot] = true;
+    }
+
+    return true;
+}
+
+// 在编译期搜索第一个可用的奇数种子，找不到时返回 0
+constexpr uint32_t findSeed()
+{
+    for (uint32_t seed = 1; seed < 1u << 16; seed += 2)
+    {
+        if (isPerfectSeed(seed))
+        {
+            return seed;
+        }
+    }
+
+    return 0;
+}
 
-// 生成一个哈希表优化查询时间复杂度
-static const std::unordered_map<std::string, size_t> keywordsMap = buildKeywordIndexMap();
+constexpr uint32_t SEED = findSeed();
+
+static_assert(SEED != 0, "No perfect hash seed found for the keyword table");
+
+// 槽位到关键字下标的映射
+constexpr std::array<uint8_t, TABLE_SIZE> buildTable()
+{
+    std::array<uint8_t, TABLE_SIZE> table{};
+
+    for (uint8_t &slot : table)
+    {
+        slot = EMPTY_SLOT;
+    }
+
+    for (size_t i = 0; i < keywords.size(); ++i)
+    {
+        table[slotOf(keywords[i], SEED)] = (uint8_t)i;
+    }
+
+    return table;
+}
+
+constexpr std::array<uint8_t, TABLE_SIZE> table = buildTable();
+} // namespace KeywordHash
 
 /*
  * Token 是在编译阶段的最小有意义的单元
@@ -142,53 +228,68 @@ static const std::unordered_map<std::string, size_t> keywordsMap = buildKeywordI
  * 单个 Token 每个字符都是不可分割的整体，强行分割会改变语义
  * 每个 Token 都有一个自己的类型，例如关键字、字面量等
  * 同类型的 Token 可以有不同的值，例如同样的数字字面量类型 Token 可以为 123 也可以是 456
- * 同时为了方便错误处理，还会保留这个 Token 的文件、行信息
+ * Token 本身不保存值，只记录它在源文件中的范围，值通过 Context::getTokenValue 从源代码中切出来
+ * 标识符在词法分析时就会被驻留，之后的阶段直接使用它的 NameId
+ * 为了方便错误处理，还会保留这个 Token 所在的文件，行列信息在需要时通过 LineTable 从 offset 计算
  */
 struct Token
 {
+    // literalIndex 的默认值，表示 Token 的值就是源代码的切片
+    static constexpr uint32_t NO_LITERAL = UINT32_MAX;
+
     // 这个 Token 的类型
     TokenCode code = TokenCode::UNDEFINED;
-    // Token 的值
-    std::string value = "";
-    // Token 的文件路径
-    std::string filePath = "";
-    // Token 的起始下标
-    size_t col = 0, line = 0, pos = 0, lineStart = 0;
+    // Token 所在源文件的编号
+    uint16_t fileId = 0;
+    // Token 在源文件中的起始下标和长度（包括字面量两侧的引号）
+    uint32_t offset = 0, length = 0;
+    union
+    {
+        // 经过转义处理的字面量值在 Context::literalPool 中的下标，只有和源代码不同时才会存储
+        uint32_t literalIndex = NO_LITERAL;
+        // 标识符在 StringInterner 中的编号，只对 IDENTIFIER 有效
+        uint32_t nameId;
+    };
+
+    // 是否有保存在 Context::literalPool 中的值
+    inline bool hasLiteral() const
+    {
+        return code != TokenCode::IDENTIFIER && literalIndex != NO_LITERAL;
+    }
 };
 
+static_assert(sizeof(Token) == 16, "Token should stay compact");
+
 // TokenStream 存储了一个翻译单元的所有 Token
 using TokenStream = std::vector<Token>;
 
 // 下面定义所有关于 Token 的辅助函数
 
 /**
- * 构建哈希表，用于以 O(1) 时间复杂度检查标识符是否是关键字
+ * 获取关键字的位置
+ * 如果不存在，则返回值为 std::nullopt
+ * 通过编译期生成的完美哈希查找，不会分配内存
  */
-inline std::unordered_map<std::string, size_t> buildKeywordIndexMap()
+constexpr std::optional<size_t> getKeywordPoistion(std::string_view tokenValue)
 {
-    std::unordered_map<std::string, size_t> map;
-
-    for (size_t i = 0; i < keywords.size(); ++i)
+    if (tokenValue.empty() || tokenValue.size() > MAX_KEYWORD_SIZE)
     {
-        map[keywords[i]] = i;
+        return std::nullopt;
     }
 
-    return map;
-}
+    const uint8_t index = KeywordHash::table[KeywordHash::slotOf(tokenValue, KeywordHash::SEED)];
 
-/**
- * 获取关键字的位置
- * 如果不存在，则返回值为 std::nullopt
- */
-inline std::optional<size_t> getKeywordPoistion(const std::string &tokenValue)
-{
-    if (auto it = keywordsMap.find(tokenValue); it != keywordsMap.end())
+    if (index != KeywordHash::EMPTY_SLOT && keywords[index] == tokenValue)
     {
-        return it->second;
+        return index;
     }
     return std::nullopt;
 }
 
+static_assert(getKeywordPoistion("struct") == (size_t)TokenCode::STRUCT - (size_t)TokenCode::IMPT, "Keyword hash is broken");
+static_assert(getKeywordPoistion("false") == (size_t)TokenCode::BOOLEAN_FALSE - (size_t)TokenCode::IMPT, "Keyword hash is broken");
+static_assert(!getKeywordPoistion("structs"), "Keyword hash is broken");
+
 /**
  * 判断一个字符是否是字母
  */
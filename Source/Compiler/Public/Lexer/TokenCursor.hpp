@@ -0,0 +1,77 @@
+/**
+ * Copyright 2025, LiserverYang. All rights reserved.
+ * 此文件定义了 TokenCursor ，Parser 通过它读取 Token
+ */
+
+#pragma once
+
+#include "Lexer/Lexer.hpp"
+#include "Lexer/Token.hpp"
+
+#include <array>
+#include <memory>
+
+/**
+ * TokenCursor 是 Parser 读取 Token 的游标，有两种模式：
+ * 1. 读取已经由 Lexer 生成好的完整 TokenStream
+ * 2. 流式模式，持有一个 Lexer ，只在需要时解析下一个 Token ，并保存在一个固定大小的环形缓冲区中
+ * 流式模式下只能访问最近 RING_SIZE 个 Token ，向前看和回退的距离都不能超过这个范围
+ */
+class TokenCursor
+{
+public:
+    // 环形缓冲区的大小，必须是 2 的幂
+    static constexpr size_t RING_SIZE = 64;
+
+    TokenCursor() = default;
+    explicit TokenCursor(const TokenStream *stream) : stream(stream) {}
+    explicit TokenCursor(std::unique_ptr<Lexer> lexer) : lexer(std::move(lexer)) {}
+
+    /**
+     * 获取当前位置之后第 ahead 个 Token ，不存在时返回 nullptr
+     */
+    const Token *peek(size_t ahead = 0);
+
+    inline bool finished()
+    {
+        return peek() == nullptr;
+    }
+
+    inline void advance()
+    {
+        position += 1;
+    }
+
+    // 上一个被读取的 Token ，用于在文件意外结束时报告错误
+    const Token &previous() const;
+
+    inline size_t getPosition() const
+    {
+        return position;
+    }
+
+    /**
+     * 回到之前通过 getPosition 记录的位置
+     * 流式模式下如果这个位置已经被移出缓冲区会抛出 std::logic_error
+     */
+    void rewind(size_t target);
+
+private:
+    static_assert((RING_SIZE & (RING_SIZE - 1)) == 0, "RING_SIZE must be a power of two");
+
+    // 当前读取到的位置，两种模式下都是 Token 在整个文件中的序号
+    size_t position = 0;
+
+    const TokenStream *stream = nullptr;
+
+    std::unique_ptr<Lexer> lexer;
+    std::array<Token, RING_SIZE> ring;
+    // 已经解析出的 Token 数量
+    size_t produced = 0;
+    bool exhausted = false;
+
+    inline bool isBuffered(size_t index) const
+    {
+        return index < produced && index + RING_SIZE >= produced;
+    }
+};
\ No newline at end of file
@@ -3,7 +3,12 @@
  * 定义输出系统
  */
 
+#pragma once
+
+#include "Core/LineTable.hpp"
+
 #include <string>
+#include <string_view>
 
 /*
  * Logger 定义了编译器的三种输出：
@@ -21,16 +26,25 @@ public:
         INFO
     };
 
+    /**
+     * LogInfo 只记录出错位置的下标，行列信息在输出时通过 lineTable 计算
+     */
     struct LogInfo
     {
-        const std::string *code;
+        std::string_view code;
         std::string codePath;
         std::string msg;
-        size_t line, col;
+        size_t position;
         size_t length;
-        size_t beginPosition;
+        LineTable *lineTable;
     };
 
 public:
     static void Log(LogLevel level, LogInfo info);
+
+    // 和 Log 相同，但是错误不会终止编译，用于可以继续分析的错误，例如 Parser 中的语法错误
+    static void Print(LogLevel level, LogInfo info);
+
+    // 输出和源代码中具体位置无关的信息，例如无法打开文件
+    static void Log(LogLevel level, std::string codePath, std::string msg);
 };
\ No newline at end of file
@@ -5,50 +5,280 @@
 
 #pragma once
 
-#include <memory>
+#include "Core/StringInterner.hpp"
+#include "Lexer/Token.hpp"
+
+#include <cstddef>
+#include <array>
+#include <cstdint>
 #include <optional>
+#include <ostream>
+#include <stdexcept>
 #include <string>
-#include <utility>
+#include <string_view>
 #include <vector>
 
+/**
+ * ASTList 是 AST 节点中的列表，元素存放在 ASTContext 的内存池中
+ * 它只保存指针和长度，平凡析构，由 ASTContext::createList 创建
+ */
+template <typename T>
+class ASTList
+{
+public:
+    ASTList() = default;
+    ASTList(T *items, uint32_t count) : items(items), count(count) {}
+
+    inline T *begin() const
+    {
+        return items;
+    }
+
+    inline T *end() const
+    {
+        return items + count;
+    }
+
+    inline size_t size() const
+    {
+        return count;
+    }
+
+    inline bool empty() const
+    {
+        return count == 0;
+    }
+
+    inline T &operator[](size_t index) const
+    {
+        return items[index];
+    }
+
+private:
+    T *items = nullptr;
+    uint32_t count = 0;
+};
+
+/**
+ * ASTKind 是节点的具体类型，每个节点在创建时记录自己的 ASTKind
+ * 语句和表达式的编号是连续的，判断一个节点是不是 Stmt 或 Expr 只需要比较范围
+ */
+enum class ASTKind : uint8_t
+{
+    Program,
+    ModulePath,
+    Type,
+    ImportStmt,
+    MemberVarDef,
+    StructDef,
+    Param,
+    SelfParam,
+    MemberFunctionDef,
+    StructImpl,
+    FunctionDef,
+    GlobalVarDef,
+
+    // 语句
+    CompoundStmt,
+    IfStmt,
+    ReturnStmt,
+    DeclStmt,
+    AssignStmt,
+    ExprStmt,
+    ForStmt,
+    WhileStmt,
+    ErrorStmt,
+
+    // 表达式
+    LiteralExpr,
+    IdentifierExpr,
+    ModuleIdentifierExpr,
+    StructInitExpr,
+    StaticMemberCall,
+    MemberFunctionCall,
+    FunctionCall,
+    MemberAccess,
+    BinaryOp,
+    UnaryOp,
+    CastExpr,
+    ParenExpr,
+
+    FIRST_STMT = CompoundStmt,
+    LAST_STMT = ErrorStmt,
+    FIRST_EXPR = LiteralExpr,
+    LAST_EXPR = ParenExpr
+};
+
+constexpr size_t AST_KIND_COUNT = (size_t)ASTKind::LAST_EXPR + 1;
+
+// 每种节点的名字，和 ASTKind 的顺序一致
+constexpr std::array<std::string_view, AST_KIND_COUNT> astKindNames = {
+    "Program",
+    "ModulePath",
+    "Type",
+    "ImportStmt",
+    "MemberVarDef",
+    "StructDef",
+    "Param",
+    "SelfParam",
+    "MemberFunctionDef",
+    "StructImpl",
+    "FunctionDef",
+    "GlobalVarDef",
+    "CompoundStmt",
+    "IfStmt",
+    "ReturnStmt",
+    "DeclStmt",
+    "AssignStmt",
+    "ExprStmt",
+    "ForStmt",
+    "WhileStmt",
+    "ErrorStmt",
+    "LiteralExpr",
+    "IdentifierExpr",
+    "ModuleIdentifierExpr",
+    "StructInitExpr",
+    "StaticMemberCall",
+    "MemberFunctionCall",
+    "FunctionCall",
+    "MemberAccess",
+    "BinaryOp",
+    "UnaryOp",
+    "CastExpr",
+    "ParenExpr"
+};
+
+inline std::string_view getKindName(ASTKind kind)
+{
+    return astKindNames[(size_t)kind];
+}
+
 // 基类
 class ASTNode
 {
 public:
-    size_t line, col, lineStart;
-    virtual ~ASTNode() = default;
+    // 节点在源文件中的下标，行列信息通过 Context::getLocation 计算
+    // 节点中的名字都是驻留过的 NameId ，字符串通过 NameId::str 获取
+    // 节点由 ASTContext 分配，不会单独析构，成员只能是平凡析构的类型，可以为空的子节点用空指针表示
+    uint32_t offset = 0;
+
+    inline ASTKind getKind() const
+    {
+        return nodeKind;
+    }
+
+protected:
+    explicit ASTNode(ASTKind kind) : nodeKind(kind) {}
+
+private:
+    ASTKind nodeKind;
 };
 
+/**
+ * 类似 LLVM 的 isa 、cast 和 dyn_cast ，通过 ASTKind 判断节点类型，不依赖 RTTI
+ * 具体的节点类型通过 KIND 判断，Expr 和 Stmt 这样的基类自己定义 classof
+ */
+template <typename T>
+inline bool isa(const ASTNode *node)
+{
+    if constexpr (requires { T::KIND; })
+    {
+        return node->getKind() == T::KIND;
+    }
+    else
+    {
+        return T::classof(node);
+    }
+}
+
+// 节点一定是 T 类型时使用，调试模式下会检查
+template <typename T>
+inline T *cast(ASTNode *node)
+{
+#ifdef __DEBUG__
+    if (!isa<T>(node))
+    {
+        throw std::logic_error("invalid AST cast from " + std::string(getKindName(node->getKind())));
+    }
+#endif
+    return static_cast<T *>(node);
+}
+
+template <typename T>
+inline const T *cast(const ASTNode *node)
+{
+    return cast<T>(const_cast<ASTNode *>(node));
+}
+
+// 节点不是 T 类型或者是空指针时返回 nullptr
+template <typename T>
+inline T *dyn_cast(ASTNode *node)
+{
+    return node != nullptr && isa<T>(node) ? static_cast<T *>(node) : nullptr;
+}
+
+template <typename T>
+inline const T *dyn_cast(const ASTNode *node)
+{
+    return dyn_cast<T>(const_cast<ASTNode *>(node));
+}
+
 class Expr : public ASTNode
 {
+public:
+    static bool classof(const ASTNode *node)
+    {
+        return node->getKind() >= ASTKind::FIRST_EXPR && node->getKind() <= ASTKind::LAST_EXPR;
+    }
+
+protected:
+    using ASTNode::ASTNode;
 };
+
 class Stmt : public ASTNode
 {
+public:
+    static bool classof(const ASTNode *node)
+    {
+        return node->getKind() >= ASTKind::FIRST_STMT && node->getKind() <= ASTKind::LAST_STMT;
+    }
+
+protected:
+    using ASTNode::ASTNode;
 };
 
 class Type;
 class FunctionDef;
 class StructImpl;
 
-// 程序节点
+// 程序节点，由 Context 持有，全局语句本身仍然分配在 ASTContext 中
 class Program : public ASTNode
 {
 public:
-    std::vector<std::unique_ptr<ASTNode>> globalStatements;
+    static constexpr ASTKind KIND = ASTKind::Program;
+    Program() : ASTNode(KIND) {}
+
+    std::vector<ASTNode *> globalStatements;
 };
 
 // 模块路径节点
 class ModulePath : public ASTNode
 {
 public:
-    std::vector<std::string> pathSegments;
+    static constexpr ASTKind KIND = ASTKind::ModulePath;
+    ModulePath() : ASTNode(KIND) {}
+
+    ASTList<NameId> pathSegments;
 };
 
 // 类型节点
 class Type : public ASTNode
 {
 public:
-    enum class TypeKind
+    static constexpr ASTKind KIND = ASTKind::Type;
+    Type() : ASTNode(KIND) {}
+
+    enum class TypeKind : uint8_t
     {
         Primitive,
         Custom,
@@ -58,156 +288,236 @@ public:
     bool isReference = false;
     bool isMutReference = false;
     TypeKind kind;
-    std::string typeName;                   // 基础类型名或标识符
-    std::unique_ptr<ModulePath> modulePath; // 仅当是模块限定类型时使用
+    NameId typeName;                  // 基础类型名或标识符
+    ModulePath *modulePath = nullptr; // 仅当是模块限定类型时使用
 };
 
 // 导入语句节点
 class ImportStmt : public ASTNode
 {
 public:
-    std::unique_ptr<ModulePath> modulePath;
-    std::optional<std::vector<std::string>> symbols; // nullopt 表示导入全部
-    std::optional<std::string> alias; // nullopt 表示通配符导入
+    static constexpr ASTKind KIND = ASTKind::ImportStmt;
+    ImportStmt() : ASTNode(KIND) {}
+
+    ModulePath *modulePath = nullptr;
+    std::optional<ASTList<NameId>> symbols; // nullopt 表示导入全部
+    NameId alias; // 为空表示没有别名
 };
 
 // 结构体成员变量节点
 class MemberVarDef : public ASTNode
 {
 public:
+    static constexpr ASTKind KIND = ASTKind::MemberVarDef;
+    MemberVarDef() : ASTNode(KIND) {}
+
     bool isPublic;
-    std::string name;
-    std::unique_ptr<Type> type;
+    NameId name;
+    Type *type = nullptr;
 };
 
 // 结构体定义节点
 class StructDef : public ASTNode
 {
 public:
-    std::string name;
-    std::vector<std::unique_ptr<MemberVarDef>> members;
+    static constexpr ASTKind KIND = ASTKind::StructDef;
+    StructDef() : ASTNode(KIND) {}
+
+    NameId name;
+    ASTList<MemberVarDef *> members;
 };
 
 // 函数参数节点
 class Param : public ASTNode
 {
 public:
-    std::string name;
-    std::optional<std::unique_ptr<Type>> type;
-    std::optional<std::unique_ptr<Expr>> defaultValue;
+    static constexpr ASTKind KIND = ASTKind::Param;
+    Param() : ASTNode(KIND) {}
+
+    NameId name;
+    Type *type = nullptr;
+    Expr *defaultValue = nullptr;
 };
 
 // Self参数节点
 class SelfParam : public ASTNode
 {
 public:
+    static constexpr ASTKind KIND = ASTKind::SelfParam;
+    SelfParam() : ASTNode(KIND) {}
+
     bool isRef;
     bool isMut;
-    std::optional<std::unique_ptr<Type>> type;
+    Type *type = nullptr;
 };
 
 // 成员函数定义节点
 class MemberFunctionDef : public ASTNode
 {
 public:
-    std::string name;
-    std::optional<std::unique_ptr<SelfParam>> selfParam;
-    std::vector<std::unique_ptr<Param>> params;
-    std::optional<std::unique_ptr<Type>> returnType;
-    std::unique_ptr<Stmt> body; // CompoundStmt
+    static constexpr ASTKind KIND = ASTKind::MemberFunctionDef;
+    MemberFunctionDef() : ASTNode(KIND) {}
+
+    NameId name;
+    SelfParam *selfParam = nullptr;
+    ASTList<Param *> params;
+    Type *returnType = nullptr;
+    Stmt *body = nullptr; // CompoundStmt
+
+    // 延迟解析时函数体在 TokenStream 中的范围，见 CompileOptions::lazyFunctionBodies
+    uint32_t bodyTokenBegin = 0;
+    uint32_t bodyTokenEnd = 0;
+
+    inline bool hasPendingBody() const
+    {
+        return body == nullptr && bodyTokenBegin != bodyTokenEnd;
+    }
 };
 
 // 结构体实现节点
 class StructImpl : public ASTNode
 {
 public:
-    std::string structName;
-    std::vector<std::unique_ptr<MemberFunctionDef>> methods;
+    static constexpr ASTKind KIND = ASTKind::StructImpl;
+    StructImpl() : ASTNode(KIND) {}
+
+    NameId structName;
+    ASTList<MemberFunctionDef *> methods;
 };
 
 // 函数定义节点
 class FunctionDef : public ASTNode
 {
 public:
-    std::string name;
-    std::vector<std::unique_ptr<Param>> params;
-    std::optional<std::unique_ptr<Type>> returnType;
-    std::unique_ptr<Stmt> body; // CompoundStmt
+    static constexpr ASTKind KIND = ASTKind::FunctionDef;
+    FunctionDef() : ASTNode(KIND) {}
+
+    NameId name;
+    ASTList<Param *> params;
+    Type *returnType = nullptr;
+    Stmt *body = nullptr; // CompoundStmt
+
+    // 延迟解析时函数体在 TokenStream 中的范围，见 CompileOptions::lazyFunctionBodies
+    uint32_t bodyTokenBegin = 0;
+    uint32_t bodyTokenEnd = 0;
+
+    inline bool hasPendingBody() const
+    {
+        return body == nullptr && bodyTokenBegin != bodyTokenEnd;
+    }
 };
 
 // 全局变量定义节点
 class GlobalVarDef : public ASTNode
 {
 public:
+    static constexpr ASTKind KIND = ASTKind::GlobalVarDef;
+    GlobalVarDef() : ASTNode(KIND) {}
+
     bool isMove;
-    std::string name;
-    std::optional<std::unique_ptr<Type>> type;
-    std::unique_ptr<Expr> initValue;
+    NameId name;
+    Type *type = nullptr;
+    Expr *initValue = nullptr;
 };
 
 // === 语句节点 ===
 class CompoundStmt : public Stmt
 {
 public:
-    std::vector<std::unique_ptr<Stmt>> statements;
+    static constexpr ASTKind KIND = ASTKind::CompoundStmt;
+    CompoundStmt() : Stmt(KIND) {}
+
+    ASTList<Stmt *> statements;
 };
 
 class IfStmt : public Stmt
 {
 public:
-    std::unique_ptr<Expr> condition;
-    std::unique_ptr<Stmt> thenBranch;
-    std::optional<std::unique_ptr<Stmt>> elseBranch;
+    static constexpr ASTKind KIND = ASTKind::IfStmt;
+    IfStmt() : Stmt(KIND) {}
+
+    Expr *condition = nullptr;
+    Stmt *thenBranch = nullptr;
+    Stmt *elseBranch = nullptr;
 };
 
 class ReturnStmt : public Stmt
 {
 public:
-    std::optional<std::unique_ptr<Expr>> returnValue;
+    static constexpr ASTKind KIND = ASTKind::ReturnStmt;
+    ReturnStmt() : Stmt(KIND) {}
+
+    Expr *returnValue = nullptr;
 };
 
 class DeclStmt : public Stmt
 {
 public:
+    static constexpr ASTKind KIND = ASTKind::DeclStmt;
+    DeclStmt() : Stmt(KIND) {}
+
     bool isMutable;
-    std::string name;
-    std::optional<std::unique_ptr<Type>> type;
-    std::optional<std::unique_ptr<Expr>> initValue;
+    NameId name;
+    Type *type = nullptr;
+    Expr *initValue = nullptr;
 };
 
 class AssignStmt : public Stmt
 {
 public:
-    std::unique_ptr<Expr> target;
-    std::unique_ptr<Expr> value;
+    static constexpr ASTKind KIND = ASTKind::AssignStmt;
+    AssignStmt() : Stmt(KIND) {}
+
+    Expr *target = nullptr;
+    Expr *value = nullptr;
 };
 
 class ExprStmt : public Stmt
 {
 public:
-    std::unique_ptr<Expr> expression;
+    static constexpr ASTKind KIND = ASTKind::ExprStmt;
+    ExprStmt() : Stmt(KIND) {}
+
+    Expr *expression = nullptr;
 };
 
 class ForStmt : public Stmt
 {
 public:
-    std::string loopVar;
-    std::unique_ptr<Expr> iterable;
-    std::unique_ptr<Stmt> body;
+    static constexpr ASTKind KIND = ASTKind::ForStmt;
+    ForStmt() : Stmt(KIND) {}
+
+    NameId loopVar;
+    Expr *iterable = nullptr;
+    Stmt *body = nullptr;
 };
 
 class WhileStmt : public Stmt
 {
 public:
-    std::unique_ptr<Expr> condition;
-    std::unique_ptr<Stmt> body;
+    static constexpr ASTKind KIND = ASTKind::WhileStmt;
+    WhileStmt() : Stmt(KIND) {}
+
+    Expr *condition = nullptr;
+    Stmt *body = nullptr;
+};
+
+// 无法解析的语句或全局声明，Parser 报告错误并跳过一段 Token 之后用它占位
+class ErrorStmt : public Stmt
+{
+public:
+    static constexpr ASTKind KIND = ASTKind::ErrorStmt;
+    ErrorStmt() : Stmt(KIND) {}
 };
 
 // === 表达式节点 ===
 class LiteralExpr : public Expr
 {
 public:
-    enum class LiteralType
+    static constexpr ASTKind KIND = ASTKind::LiteralExpr;
+    LiteralExpr() : Expr(KIND) {}
+
+    enum class LiteralType : uint8_t
     {
         Int,
         Float,
@@ -217,76 +527,174 @@ public:
     };
 
     LiteralType type;
-    std::string value;
+
+    // 字面量 Token 的长度和转义处理之后的值在 Context::literalPool 中的下标，值通过 Context::getLiteralValue 获取
+    uint32_t length = 0;
+    uint32_t literalIndex = Token::NO_LITERAL;
 };
 
 class IdentifierExpr : public Expr
 {
 public:
-    std::string name;
+    static constexpr ASTKind KIND = ASTKind::IdentifierExpr;
+    IdentifierExpr() : Expr(KIND) {}
+
+    NameId name;
 };
 
 class ModuleIdentifierExpr : public Expr
 {
 public:
-    std::unique_ptr<ModulePath> modulePath;
-    std::string name;
+    static constexpr ASTKind KIND = ASTKind::ModuleIdentifierExpr;
+    ModuleIdentifierExpr() : Expr(KIND) {}
+
+    ModulePath *modulePath = nullptr;
+    NameId name;
+};
+
+// 结构体初始化中的一个成员，例如 Point2D { x: 1 } 中的 x: 1
+struct MemberInit
+{
+    NameId name;
+    Expr *value = nullptr;
 };
 
 class StructInitExpr : public Expr
 {
 public:
-    std::unique_ptr<Type> structType;
-    std::vector<std::pair<std::string, std::unique_ptr<Expr>>> memberInits;
+    static constexpr ASTKind KIND = ASTKind::StructInitExpr;
+    StructInitExpr() : Expr(KIND) {}
+
+    Type *structType = nullptr;
+    ASTList<MemberInit> memberInits;
 };
 
 class StaticMemberCall : public Expr
 {
 public:
-    std::unique_ptr<Type> classType;
-    std::string methodName;
-    std::vector<std::unique_ptr<Expr>> arguments;
+    static constexpr ASTKind KIND = ASTKind::StaticMemberCall;
+    StaticMemberCall() : Expr(KIND) {}
+
+    Type *classType = nullptr;
+    NameId methodName;
+    ASTList<Expr *> arguments;
 };
 
 class MemberFunctionCall : public Expr
 {
 public:
-    std::unique_ptr<Expr> object;
-    std::string methodName;
-    std::vector<std::unique_ptr<Expr>> arguments;
+    static constexpr ASTKind KIND = ASTKind::MemberFunctionCall;
+    MemberFunctionCall() : Expr(KIND) {}
+
+    Expr *object = nullptr;
+    NameId methodName;
+    ASTList<Expr *> arguments;
 };
 
 class FunctionCall : public Expr
 {
 public:
-    std::unique_ptr<Expr> function;
-    std::vector<std::unique_ptr<Expr>> arguments;
+    static constexpr ASTKind KIND = ASTKind::FunctionCall;
+    FunctionCall() : Expr(KIND) {}
+
+    Expr *function = nullptr;
+    ASTList<Expr *> arguments;
 };
 
 class MemberAccess : public Expr
 {
 public:
-    std::unique_ptr<Expr> object;
-    std::string memberName;
+    static constexpr ASTKind KIND = ASTKind::MemberAccess;
+    MemberAccess() : Expr(KIND) {}
+
+    Expr *object = nullptr;
+    NameId memberName;
+};
+
+// 二元运算符的种类
+enum class BinaryOpKind : uint8_t
+{
+    Mul,        // *
+    Div,        // /
+    Add,        // +
+    Sub,        // -
+    Less,       // <
+    LessEq,     // <=
+    Greater,    // >
+    GreaterEq,  // >=
+    Equal,      // ==
+    NotEqual,   // !=
+    BitAnd,     // &
+    BitOr,      // |
+    LogicalAnd, // &&
+    LogicalOr   // ||
 };
 
+constexpr size_t BINARY_OP_KIND_COUNT = (size_t)BinaryOpKind::LogicalOr + 1;
+
+// 每种二元运算符在源代码中的写法，和 BinaryOpKind 的顺序一致
+constexpr std::array<std::string_view, BINARY_OP_KIND_COUNT> binaryOpSpellings = {"*", "/", "+", "-", "<", "<=", ">", ">=", "==", "!=", "&", "|", "&&", "||"};
+
+inline std::string_view getBinaryOpSpelling(BinaryOpKind kind)
+{
+    return binaryOpSpellings[(size_t)kind];
+}
+
+inline std::ostream &operator<<(std::ostream &os, BinaryOpKind kind)
+{
+    return os << getBinaryOpSpelling(kind);
+}
+
 class BinaryOp : public Expr
 {
 public:
-    std::unique_ptr<Expr> left;
-    std::string op; // "+", "==", "<=" 等
-    std::unique_ptr<Expr> right;
+    static constexpr ASTKind KIND = ASTKind::BinaryOp;
+    BinaryOp() : Expr(KIND) {}
+
+    Expr *left = nullptr;
+    BinaryOpKind op = BinaryOpKind::Add;
+    Expr *right = nullptr;
+};
+
+// 一元运算符的种类
+enum class UnaryOpKind : uint8_t
+{
+    Not,   // !
+    Negate // -
+};
+
+constexpr std::array<std::string_view, 2> unaryOpSpellings = {"!", "-"};
+
+inline std::string_view getUnaryOpSpelling(UnaryOpKind kind)
+{
+    return unaryOpSpellings[(size_t)kind];
+}
+
+class UnaryOp : public Expr
+{
+public:
+    static constexpr ASTKind KIND = ASTKind::UnaryOp;
+    UnaryOp() : Expr(KIND) {}
+
+    UnaryOpKind op = UnaryOpKind::Not;
+    Expr *operand = nullptr;
 };
 
 class CastExpr : public Expr
 {
 public:
-    std::unique_ptr<Type> targetType;
-    std::unique_ptr<Expr> expression;
+    static constexpr ASTKind KIND = ASTKind::CastExpr;
+    CastExpr() : Expr(KIND) {}
+
+    Type *targetType = nullptr;
+    Expr *expression = nullptr;
 };
 
 class ParenExpr : public Expr
 {
 public:
-    std::unique_ptr<Expr> expression;
+    static constexpr ASTKind KIND = ASTKind::ParenExpr;
+    ParenExpr() : Expr(KIND) {}
+
+    Expr *expression = nullptr;
 };
\ No newline at end of file
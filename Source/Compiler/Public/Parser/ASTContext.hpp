@@ -0,0 +1,130 @@
+/**
+ * Copyright 2025, LiserverYang. All rights reserved.
+ * 此文件定义了存放 AST 节点的内存池 ASTContext
+ */
+
+#pragma once
+
+#include "Parser/AST.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/**
+ * ASTListBuilder 在解析时临时收集一个列表的元素，之后由 ASTContext::createList 复制进内存池
+ * 前 N 个元素存放在对象内部，大多数列表（参数、语句、实参）不需要任何堆分配
+ */
+template <typename T, size_t N = 8>
+class ASTListBuilder
+{
+public:
+    void push_back(const T &item)
+    {
+        if (count < N)
+        {
+            inlineItems[count] = item;
+        }
+        else
+        {
+            if (count == N)
+            {
+                overflow.assign(inlineItems, inlineItems + N);
+            }
+
+            overflow.push_back(item);
+        }
+
+        count++;
+    }
+
+    template <typename... Args>
+    void emplace_back(Args &&...args)
+    {
+        push_back(T(std::forward<Args>(args)...));
+    }
+
+    inline size_t size() const
+    {
+        return count;
+    }
+
+    inline const T *data() const
+    {
+        return count <= N ? inlineItems : overflow.data();
+    }
+
+private:
+    T inlineItems[N];
+    size_t count = 0;
+    std::vector<T> overflow;
+};
+
+/**
+ * ASTContext 是 AST 节点的内存池，由 Context 持有
+ * 节点通过移动指针的方式从大块内存中分配，相邻解析的节点在内存中也相邻
+ * 节点不会被单独释放，析构函数也不会被调用，所以节点的成员只能是平凡析构的类型（指针、NameId、ASTList 等）
+ * 整个 AST 在 ASTContext 析构或者 reset 时一次性释放
+ */
+class ASTContext
+{
+public:
+    ASTContext() = default;
+
+    ASTContext(const ASTContext &) = delete;
+    ASTContext &operator=(const ASTContext &) = delete;
+
+    // 分配一块 size 字节、按 alignment 对齐的内存，alignment 必须是 2 的幂
+    void *allocate(size_t size, size_t alignment);
+
+    template <typename T>
+    inline T *create()
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "AST nodes are never destroyed individually");
+        return new (allocate(sizeof(T), alignof(T))) T();
+    }
+
+    // 把 builder 中的元素复制到内存池中
+    template <typename T, size_t N>
+    ASTList<T> createList(const ASTListBuilder<T, N> &builder)
+    {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>);
+
+        if (builder.size() == 0)
+        {
+            return ASTList<T>();
+        }
+
+        T *items = static_cast<T *>(allocate(sizeof(T) * builder.size(), alignof(T)));
+        std::uninitialized_copy_n(builder.data(), builder.size(), items);
+
+        return ASTList<T>(items, static_cast<uint32_t>(builder.size()));
+    }
+
+    // 释放所有节点，之前返回的指针全部失效
+    void reset();
+
+    /**
+     * 接管另一个 ASTContext 的所有内存块，other 中分配的节点之后由这个 ASTContext 释放，指针仍然有效
+     * 用于把并行解析时每个任务自己的内存池合并到 Context::astContext 中
+     */
+    void adopt(ASTContext &&other);
+
+    // 已经分配给节点的字节数，不包括内存块中未使用的部分
+    inline size_t getAllocatedBytes() const
+    {
+        return allocatedBytes;
+    }
+
+private:
+    // 普通内存块的大小，超过它四分之一的分配单独使用一块内存
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<std::byte[]>> blocks;
+    std::byte *cursor = nullptr;
+    std::byte *limit = nullptr;
+
+    size_t allocatedBytes = 0;
+};
\ No newline at end of file
@@ -2,35 +2,34 @@
  * Copyright 2025, LiserverYang. All rights reserved.
  */
 
-#include <cxxabi.h>
 #include <iomanip>
 #include <iostream>
 #include <memory>
 #include <sstream>
-#include <typeinfo>
 #include <vector>
 
+#include "Core/Context.hpp"
 #include "Parser/AST.hpp"
 
-// 辅助函数：获取可读的类型名
-std::string demangle(const char *mangled);
-
 // 辅助函数：格式化指针地址
 std::string formatAddress(const void *addr);
 
-void printAST(const ASTNode *node, const std::string &prefix = "", bool isLast = true);
+void printAST(const ASTNode *node, const std::string &prefix = "", bool isLast = true, Context *context = nullptr);
 
 // 处理类型节点
 void printTypeInfo(const Type *type, std::ostream &os);
 
 // 处理各种AST节点
-void printNodeInfo(const ASTNode *node, std::ostream &os);
+void printNodeInfo(const ASTNode *node, std::ostream &os, Context *context = nullptr);
 
 // 获取节点的子节点列表
 std::vector<const ASTNode *> getChildren(const ASTNode *node);
 
 // 主打印函数
-void printAST(const ASTNode *node, const std::string &prefix, bool isLast);
+void printAST(const ASTNode *node, const std::string &prefix, bool isLast, Context *context);
 
 // 入口函数
-void printAST(const Program &program);
\ No newline at end of file
+void printAST(const Program &program);
+
+// 入口函数，同时输出每个节点的行列信息
+void printAST(Context &context);
\ No newline at end of file
@@ -0,0 +1,403 @@
+/**
+ * Copyright 2025, LiserverYang. All rights reserved.
+ * 此文件定义了扁平的、通过下标引用子节点的 AST 表示 FlatAST
+ */
+
+#pragma once
+
+#include "Parser/AST.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// FlatAST 中节点的下标
+using NodeIndex = uint32_t;
+
+// 表示不存在的子节点，对应指针形式 AST 中的空指针
+constexpr NodeIndex INVALID_NODE = UINT32_MAX;
+
+/**
+ * Flat 中的每个结构体对应一种 AST 节点，保存这种节点除了 offset 之外的所有字段
+ * 子节点用 NodeIndex 表示，列表用 ListRef 表示，所有结构体都可以直接按字节复制
+ */
+namespace Flat
+{
+// 列表在 FlatAST 的某个列表数组中占用的区间
+struct ListRef
+{
+    uint32_t first = 0;
+    uint32_t count = 0;
+};
+
+struct ModulePath
+{
+    static constexpr ASTKind KIND = ASTKind::ModulePath;
+    ListRef pathSegments; // 名字列表
+};
+
+struct Type
+{
+    static constexpr ASTKind KIND = ASTKind::Type;
+    bool isReference = false;
+    bool isMutReference = false;
+    ::Type::TypeKind kind = ::Type::TypeKind::Primitive;
+    NameId typeName;
+    NodeIndex modulePath = INVALID_NODE;
+};
+
+struct ImportStmt
+{
+    static constexpr ASTKind KIND = ASTKind::ImportStmt;
+    NodeIndex modulePath = INVALID_NODE;
+    bool importsAll = true; // 为 true 时 symbols 为空
+    ListRef symbols;        // 名字列表
+    NameId alias;
+};
+
+struct MemberVarDef
+{
+    static constexpr ASTKind KIND = ASTKind::MemberVarDef;
+    bool isPublic = false;
+    NameId name;
+    NodeIndex type = INVALID_NODE;
+};
+
+struct StructDef
+{
+    static constexpr ASTKind KIND = ASTKind::StructDef;
+    NameId name;
+    ListRef members;
+};
+
+struct Param
+{
+    static constexpr ASTKind KIND = ASTKind::Param;
+    NameId name;
+    NodeIndex type = INVALID_NODE;
+    NodeIndex defaultValue = INVALID_NODE;
+};
+
+struct SelfParam
+{
+    static constexpr ASTKind KIND = ASTKind::SelfParam;
+    bool isRef = false;
+    bool isMut = false;
+    NodeIndex type = INVALID_NODE;
+};
+
+struct MemberFunctionDef
+{
+    static constexpr ASTKind KIND = ASTKind::MemberFunctionDef;
+    NameId name;
+    NodeIndex selfParam = INVALID_NODE;
+    ListRef params;
+    NodeIndex returnType = INVALID_NODE;
+    NodeIndex body = INVALID_NODE;
+};
+
+struct StructImpl
+{
+    static constexpr ASTKind KIND = ASTKind::StructImpl;
+    NameId structName;
+    ListRef methods;
+};
+
+struct FunctionDef
+{
+    static constexpr ASTKind KIND = ASTKind::FunctionDef;
+    NameId name;
+    ListRef params;
+    NodeIndex returnType = INVALID_NODE;
+    NodeIndex body = INVALID_NODE;
+};
+
+struct GlobalVarDef
+{
+    static constexpr ASTKind KIND = ASTKind::GlobalVarDef;
+    bool isMove = false;
+    NameId name;
+    NodeIndex type = INVALID_NODE;
+    NodeIndex initValue = INVALID_NODE;
+};
+
+struct CompoundStmt
+{
+    static constexpr ASTKind KIND = ASTKind::CompoundStmt;
+    ListRef statements;
+};
+
+struct IfStmt
+{
+    static constexpr ASTKind KIND = ASTKind::IfStmt;
+    NodeIndex condition = INVALID_NODE;
+    NodeIndex thenBranch = INVALID_NODE;
+    NodeIndex elseBranch = INVALID_NODE;
+};
+
+struct ReturnStmt
+{
+    static constexpr ASTKind KIND = ASTKind::ReturnStmt;
+    NodeIndex returnValue = INVALID_NODE;
+};
+
+struct DeclStmt
+{
+    static constexpr ASTKind KIND = ASTKind::DeclStmt;
+    bool isMutable = false;
+    NameId name;
+    NodeIndex type = INVALID_NODE;
+    NodeIndex initValue = INVALID_NODE;
+};
+
+struct AssignStmt
+{
+    static constexpr ASTKind KIND = ASTKind::AssignStmt;
+    NodeIndex target = INVALID_NODE;
+    NodeIndex value = INVALID_NODE;
+};
+
+struct ExprStmt
+{
+    static constexpr ASTKind KIND = ASTKind::ExprStmt;
+    NodeIndex expression = INVALID_NODE;
+};
+
+struct ForStmt
+{
+    static constexpr ASTKind KIND = ASTKind::ForStmt;
+    NameId loopVar;
+    NodeIndex iterable = INVALID_NODE;
+    NodeIndex body = INVALID_NODE;
+};
+
+struct WhileStmt
+{
+    static constexpr ASTKind KIND = ASTKind::WhileStmt;
+    NodeIndex condition = INVALID_NODE;
+    NodeIndex body = INVALID_NODE;
+};
+
+struct ErrorStmt
+{
+    static constexpr ASTKind KIND = ASTKind::ErrorStmt;
+};
+
+struct LiteralExpr
+{
+    static constexpr ASTKind KIND = ASTKind::LiteralExpr;
+    ::LiteralExpr::LiteralType type = ::LiteralExpr::LiteralType::Int;
+    uint32_t length = 0;
+    uint32_t literalIndex = Token::NO_LITERAL;
+};
+
+struct IdentifierExpr
+{
+    static constexpr ASTKind KIND = ASTKind::IdentifierExpr;
+    NameId name;
+};
+
+struct ModuleIdentifierExpr
+{
+    static constexpr ASTKind KIND = ASTKind::ModuleIdentifierExpr;
+    NodeIndex modulePath = INVALID_NODE;
+    NameId name;
+};
+
+struct MemberInit
+{
+    NameId name;
+    NodeIndex value = INVALID_NODE;
+};
+
+struct StructInitExpr
+{
+    static constexpr ASTKind KIND = ASTKind::StructInitExpr;
+    NodeIndex structType = INVALID_NODE;
+    ListRef memberInits; // MemberInit 列表
+};
+
+struct StaticMemberCall
+{
+    static constexpr ASTKind KIND = ASTKind::StaticMemberCall;
+    NodeIndex classType = INVALID_NODE;
+    NameId methodName;
+    ListRef arguments;
+};
+
+struct MemberFunctionCall
+{
+    static constexpr ASTKind KIND = ASTKind::MemberFunctionCall;
+    NodeIndex object = INVALID_NODE;
+    NameId methodName;
+    ListRef arguments;
+};
+
+struct FunctionCall
+{
+    static constexpr ASTKind KIND = ASTKind::FunctionCall;
+    NodeIndex function = INVALID_NODE;
+    ListRef arguments;
+};
+
+struct MemberAccess
+{
+    static constexpr ASTKind KIND = ASTKind::MemberAccess;
+    NodeIndex object = INVALID_NODE;
+    NameId memberName;
+};
+
+struct BinaryOp
+{
+    static constexpr ASTKind KIND = ASTKind::BinaryOp;
+    NodeIndex left = INVALID_NODE;
+    BinaryOpKind op = BinaryOpKind::Add;
+    NodeIndex right = INVALID_NODE;
+};
+
+struct UnaryOp
+{
+    static constexpr ASTKind KIND = ASTKind::UnaryOp;
+    UnaryOpKind op = UnaryOpKind::Not;
+    NodeIndex operand = INVALID_NODE;
+};
+
+struct CastExpr
+{
+    static constexpr ASTKind KIND = ASTKind::CastExpr;
+    NodeIndex targetType = INVALID_NODE;
+    NodeIndex expression = INVALID_NODE;
+};
+
+struct ParenExpr
+{
+    static constexpr ASTKind KIND = ASTKind::ParenExpr;
+    NodeIndex expression = INVALID_NODE;
+};
+} // namespace Flat
+
+/**
+ * FlatAST 是 AST 的扁平表示，适合需要遍历整个程序的 Pass
+ * 所有节点的种类、下标和在类型数组中的位置分别存放在三个连续的数组中，节点的字段存放在按种类划分的数组中
+ * 子节点通过 32 位的 NodeIndex 引用，子节点的下标总是小于父节点（后序排列）
+ * 所有数据都是可以按字节复制的，复制、在线程之间传递和序列化都只需要复制几个数组
+ * 节点中的 NameId 只在当前进程的 StringInterner 中有效
+ */
+class FlatAST
+{
+public:
+    /**
+     * 把以 node 为根的子树追加到 FlatAST 中，返回根节点的下标
+     * node 为空指针时返回 INVALID_NODE
+     */
+    NodeIndex add(const ASTNode *node);
+
+    // 追加一个全局语句
+    inline void addRoot(const ASTNode *node)
+    {
+        roots.push_back(add(node));
+    }
+
+    inline const std::vector<NodeIndex> &getRoots() const
+    {
+        return roots;
+    }
+
+    // 节点的数量
+    inline size_t size() const
+    {
+        return kinds.size();
+    }
+
+    inline ASTKind getKind(NodeIndex node) const
+    {
+        return kinds[node];
+    }
+
+    inline uint32_t getOffset(NodeIndex node) const
+    {
+        return offsets[node];
+    }
+
+    // 获取节点的字段，节点必须是 T 对应的种类
+    template <typename T>
+    inline const T &get(NodeIndex node) const
+    {
+#ifdef __DEBUG__
+        if (kinds[node] != T::KIND)
+        {
+            throw std::logic_error("invalid FlatAST access to " + std::string(getKindName(kinds[node])));
+        }
+#endif
+        return std::get<std::vector<T>>(tables)[slots[node]];
+    }
+
+    inline std::span<const NodeIndex> getNodes(Flat::ListRef list) const
+    {
+        return std::span<const NodeIndex>(nodeLists).subspan(list.first, list.count);
+    }
+
+    inline std::span<const NameId> getNames(Flat::ListRef list) const
+    {
+        return std::span<const NameId>(nameLists).subspan(list.first, list.count);
+    }
+
+    inline std::span<const Flat::MemberInit> getMemberInits(Flat::ListRef list) const
+    {
+        return std::span<const Flat::MemberInit>(memberInitLists).subspan(list.first, list.count);
+    }
+
+    // 按照源代码中的顺序访问节点的所有子节点，跳过不存在的子节点
+    void forEachChild(NodeIndex node, const std::function<void(NodeIndex)> &visit) const;
+
+    /**
+     * 把所有数组按顺序写成一段字节，deserialize 可以从中恢复出相同的 FlatAST
+     * 只能在同一个进程内使用：NameId 的编号取决于当前进程中名字驻留的顺序，换一个进程就对应不同的名字
+     * 记录中的填充字节会被原样复制，所以相同的 AST 不一定得到相同的字节，不能用来比较或者计算哈希
+     */
+    std::vector<std::byte> serialize() const;
+
+    // 数据不完整时抛出 std::runtime_error
+    static FlatAST deserialize(std::span<const std::byte> bytes);
+
+    void clear();
+
+private:
+    using Tables = std::tuple<std::vector<Flat::ModulePath>, std::vector<Flat::Type>, std::vector<Flat::ImportStmt>,
+                              std::vector<Flat::MemberVarDef>, std::vector<Flat::StructDef>, std::vector<Flat::Param>,
+                              std::vector<Flat::SelfParam>, std::vector<Flat::MemberFunctionDef>, std::vector<Flat::StructImpl>,
+                              std::vector<Flat::FunctionDef>, std::vector<Flat::GlobalVarDef>, std::vector<Flat::CompoundStmt>,
+                              std::vector<Flat::IfStmt>, std::vector<Flat::ReturnStmt>, std::vector<Flat::DeclStmt>,
+                              std::vector<Flat::AssignStmt>, std::vector<Flat::ExprStmt>, std::vector<Flat::ForStmt>,
+                              std::vector<Flat::WhileStmt>, std::vector<Flat::ErrorStmt>, std::vector<Flat::LiteralExpr>, std::vector<Flat::IdentifierExpr>,
+                              std::vector<Flat::ModuleIdentifierExpr>, std::vector<Flat::StructInitExpr>, std::vector<Flat::StaticMemberCall>,
+                              std::vector<Flat::MemberFunctionCall>, std::vector<Flat::FunctionCall>, std::vector<Flat::MemberAccess>,
+                              std::vector<Flat::BinaryOp>, std::vector<Flat::UnaryOp>, std::vector<Flat::CastExpr>, std::vector<Flat::ParenExpr>>;
+
+    // 每个节点一项
+    std::vector<ASTKind> kinds;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> slots; // 节点在对应种类数组中的下标
+
+    Tables tables;
+
+    // ListRef 指向的列表
+    std::vector<NodeIndex> nodeLists;
+    std::vector<NameId> nameLists;
+    std::vector<Flat::MemberInit> memberInitLists;
+
+    std::vector<NodeIndex> roots;
+
+    template <typename T>
+    NodeIndex push(const ASTNode *node, const T &record);
+
+    template <typename T>
+    Flat::ListRef addList(const ASTList<T *> &list);
+    Flat::ListRef addNames(const ASTList<NameId> &list);
+    Flat::ListRef addMemberInits(const ASTList<MemberInit> &list);
+};
\ No newline at end of file
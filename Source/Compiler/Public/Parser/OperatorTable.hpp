@@ -0,0 +1,117 @@
+/**
+ * Copyright 2025, LiserverYang. All rights reserved.
+ * 此文件定义了运算符的优先级、结合性和 Pratt 解析使用的绑定强度表
+ */
+
+#pragma once
+
+#include "Lexer/Token.hpp"
+#include "Parser/AST.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+// 运算符的结合性
+enum class Associativity : uint8_t
+{
+    Left,
+    Right
+};
+
+/**
+ * 一个 TokenCode 作为二元运算符时的信息
+ * precedence 为 0 表示这个 Token 不是二元运算符，数值越大结合得越紧
+ *
+ * leftBindingPower 和 rightBindingPower 是 Pratt 解析使用的绑定强度，由优先级和结合性预先算好：
+ * 运算符只有在左绑定强度大于当前的最小绑定强度时才会继续向右结合，右侧操作数以右绑定强度为最小绑定强度解析
+ * 左结合的运算符右绑定强度比左绑定强度大 1 ，所以同一优先级的下一个运算符会结束右侧操作数
+ */
+struct BinaryOperatorInfo
+{
+    uint8_t precedence = 0;
+    Associativity associativity = Associativity::Left;
+    BinaryOpKind kind = BinaryOpKind::Add;
+
+    uint8_t leftBindingPower = 0;
+    uint8_t rightBindingPower = 0;
+
+    constexpr bool isOperator() const
+    {
+        return precedence != 0;
+    }
+};
+
+constexpr size_t TOKEN_CODE_COUNT = (size_t)TokenCode::REFERENCE + 1;
+
+// 以 TokenCode 为下标的运算符表，在编译期生成
+constexpr std::array<BinaryOperatorInfo, TOKEN_CODE_COUNT> binaryOperators = [] {
+    std::array<BinaryOperatorInfo, TOKEN_CODE_COUNT> table{};
+
+    auto set = [&](TokenCode code, uint8_t precedence, BinaryOpKind kind, Associativity associativity = Associativity::Left) {
+        const uint8_t leftBindingPower = precedence * 2;
+        const uint8_t rightBindingPower = associativity == Associativity::Left ? leftBindingPower + 1 : leftBindingPower;
+
+        table[(size_t)code] = BinaryOperatorInfo{precedence, associativity, kind, leftBindingPower, rightBindingPower};
+    };
+
+    set(TokenCode::STAR, 8, BinaryOpKind::Mul);
+    set(TokenCode::SLASH, 8, BinaryOpKind::Div);
+    set(TokenCode::PLUS, 7, BinaryOpKind::Add);
+    set(TokenCode::MINUS, 7, BinaryOpKind::Sub);
+    set(TokenCode::LT, 6, BinaryOpKind::Less);
+    set(TokenCode::LT_EQ, 6, BinaryOpKind::LessEq);
+    set(TokenCode::GT, 6, BinaryOpKind::Greater);
+    set(TokenCode::GT_EQ, 6, BinaryOpKind::GreaterEq);
+    set(TokenCode::EQ_EQ, 5, BinaryOpKind::Equal);
+    set(TokenCode::NOT_EQ, 5, BinaryOpKind::NotEqual);
+    set(TokenCode::REFERENCE, 4, BinaryOpKind::BitAnd);
+    set(TokenCode::BOR, 3, BinaryOpKind::BitOr);
+    set(TokenCode::AND, 2, BinaryOpKind::LogicalAnd);
+    set(TokenCode::OR, 1, BinaryOpKind::LogicalOr);
+
+    return table;
+}();
+
+constexpr const BinaryOperatorInfo &getBinaryOperator(TokenCode code)
+{
+    return binaryOperators[(size_t)code];
+}
+
+/**
+ * 一个 TokenCode 作为前缀运算符时的信息
+ */
+struct PrefixOperatorInfo
+{
+    bool isOperator = false;
+    UnaryOpKind kind = UnaryOpKind::Not;
+};
+
+constexpr std::array<PrefixOperatorInfo, TOKEN_CODE_COUNT> prefixOperators = [] {
+    std::array<PrefixOperatorInfo, TOKEN_CODE_COUNT> table{};
+
+    table[(size_t)TokenCode::NOT] = PrefixOperatorInfo{true, UnaryOpKind::Not};
+    table[(size_t)TokenCode::MINUS] = PrefixOperatorInfo{true, UnaryOpKind::Negate};
+
+    return table;
+}();
+
+constexpr const PrefixOperatorInfo &getPrefixOperator(TokenCode code)
+{
+    return prefixOperators[(size_t)code];
+}
+
+// 前缀运算符的操作数以它为最小绑定强度解析，比所有二元运算符都紧，例如 -a * b 是 (-a) * b
+// 后缀的成员访问和方法调用总是比前缀运算符更紧，例如 -a.b 是 -(a.b)
+constexpr uint8_t PREFIX_BINDING_POWER = [] {
+    uint8_t maxBindingPower = 0;
+    for (const BinaryOperatorInfo &info : binaryOperators)
+    {
+        maxBindingPower = std::max(maxBindingPower, info.rightBindingPower);
+    }
+    return maxBindingPower + 1;
+}();
+
+static_assert(getBinaryOperator(TokenCode::STAR).precedence > getBinaryOperator(TokenCode::PLUS).precedence);
+static_assert(getBinaryOperator(TokenCode::PLUS).rightBindingPower > getBinaryOperator(TokenCode::MINUS).leftBindingPower);
+static_assert(!getBinaryOperator(TokenCode::ASSIGN).isOperator());
\ No newline at end of file
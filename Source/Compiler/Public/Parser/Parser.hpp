@@ -5,11 +5,14 @@
 
 #pragma once
 
+#include "Core/Diagnostics.hpp"
 #include "Core/Pass.hpp"
+#include "Lexer/TokenCursor.hpp"
 #include "Logger/Logger.hpp"
 #include "Parser/AST.hpp"
+#include "Parser/ASTContext.hpp"
 
-#include <unordered_set>
+#include <vector>
 
 /**
  * Parser 是语法分析器，它会通过 TokenStream 生成 AST
@@ -27,36 +30,84 @@ public:
 
     virtual void run() override;
 
+    /**
+     * 解析一个延迟解析的函数体，函数体已经解析过时什么也不做
+     * 可以在 run 之后随时调用，也可以由一个新的 Parser 调用，例如 IDE 打开某个函数时
+     */
+    void parseBody(FunctionDef *func);
+    void parseBody(MemberFunctionDef *method);
+
+    /**
+     * 从 main 开始解析所有可能被调用到的函数体
+     * 成员函数调用时还不知道对象的类型，所以解析所有同名的成员函数
+     */
+    void parseReachableBodies();
+
 private:
-    size_t currentPos = 0;
-    size_t snapshot = 0;
-    TokenStream *tokenStream = nullptr;
+    TokenCursor tokens;
+
+    // 最近一次报告错误的位置
+    uint32_t lastErrorOffset = UINT32_MAX;
+
+    // 当前的嵌套深度
+    size_t nestingDepth = 0;
+
+    // 分配节点的内存池，为 nullptr 时使用 Context::astContext ，并行解析时每个任务使用自己的内存池
+    ASTContext *astContext = nullptr;
+
+    // 不为 nullptr 时错误先保存在这里，之后由 run 按位置排序再报告
+    std::vector<Diagnostic> *diagnosticBuffer = nullptr;
+
+    inline ASTContext &getASTContext()
+    {
+        return astContext != nullptr ? *astContext : context->astContext;
+    }
 
-    std::unordered_set<std::string> knownTypes = {"i8", "i16", "i32", "i64", "f32", "f64", "bool", "char"};
+    // 是否跳过函数体，见 CompileOptions::lazyFunctionBodies 和 CompileOptions::parserThreads
+    bool lazyBodies = false;
+    // tokens 和 knownStructs 是否已经可以用来解析函数体
+    bool readyForBodies = false;
+
+    // 已经定义的结构体，以 NameId 的编号为下标，基本类型由 TokenCode 判断，不在这里记录
+    std::vector<bool> knownStructs;
+
+    inline bool isKnownStruct(NameId name) const
+    {
+        return name.id < knownStructs.size() && knownStructs[name.id];
+    }
+
+    inline void addKnownStruct(NameId name)
+    {
+        if (name.id >= knownStructs.size())
+        {
+            knownStructs.resize(name.id + 1);
+        }
+        knownStructs[name.id] = true;
+    }
 
     /* 辅助函数 */
 
     inline void advance()
     {
-        currentPos += 1;
+        tokens.advance();
     }
 
     inline bool finished()
     {
-        return currentPos >= tokenStream->size();
+        return tokens.finished();
     }
 
-    inline Token &currentToken()
+    // 流式模式下返回的引用只在之后的 TokenCursor::RING_SIZE 个 Token 内有效，需要长期保存时应该复制
+    inline const Token &currentToken()
     {
-        if (finished())
-        {
-            Logger::LogInfo logInfo;
-            initLogInfo(tokenStream->at(currentPos - 1), logInfo, "Unexpect finishing");
+        const Token *token = tokens.peek();
 
-            Logger::Log(Logger::LogLevel::ERROR, logInfo);
+        if (token == nullptr)
+        {
+            error(tokens.previous(), "Unexpect finishing");
         }
 
-        return tokenStream->at(currentPos);
+        return *token;
     }
 
     inline bool match(TokenCode code)
@@ -75,28 +126,14 @@ private:
         return currentToken().code == code;
     }
 
-    inline Token &consume(TokenCode code, Logger::LogInfo &logInfo)
+    inline Token consume(TokenCode code, std::string msg)
     {
-        if (finished() || currentToken().code != code)
+        if (currentToken().code != code)
         {
-            Logger::Log(Logger::LogLevel::ERROR, logInfo);
+            error(currentToken(), std::move(msg));
         }
 
-        Token &result = currentToken();
-
-        return advance(), result;
-    }
-
-    inline Token &consume(TokenCode code, std::string msg)
-    {
-        if (finished() || currentToken().code != code)
-        {
-            Logger::LogInfo logInfo;
-            initLogInfo(currentToken(), logInfo, msg);
-            Logger::Log(Logger::LogLevel::ERROR, logInfo);
-        }
-
-        Token &result = currentToken();
+        Token result = currentToken();
 
         return advance(), result;
     }
@@ -114,62 +151,165 @@ private:
         return false;
     }
 
-    inline void initLogInfo(Token &token, Logger::LogInfo &logInfo, std::string msg)
+    inline std::string_view getTokenValue(const Token &token)
+    {
+        return context->getTokenValue(token);
+    }
+
+    // 获取 Token 对应的名字，标识符在词法分析时已经驻留，关键字（例如基础类型名）在这里驻留
+    inline NameId getTokenName(const Token &token)
     {
-        logInfo.codePath = context->filePath;
-        logInfo.code = &context->fileValue;
-        logInfo.col = token.col;
-        logInfo.line = token.line;
-        logInfo.length = token.value.size();
-        logInfo.beginPosition = token.lineStart;
-        logInfo.msg = msg;
+        if (token.code == TokenCode::IDENTIFIER)
+        {
+            return NameId(token.nameId);
+        }
+
+        return NameId::get(getTokenValue(token));
     }
 
-    inline void createSnapshot()
+    /* 错误处理 */
+
+    /**
+     * 语法错误在 Context::diagnostics 中记录之后抛出 ParseError
+     * parseGlobalStatement 和 parseStatementOrRecover 捕获它，跳过一段 Token 重新同步，然后继续解析
+     */
+    struct ParseError
+    {
+    };
+
+    // 报告一个错误，但是当前的语句仍然可以继续解析，例如未定义的类型
+    inline void reportError(const Token &token, std::string msg)
     {
-        snapshot = currentPos;
+        // 外层的语句在同一个位置恢复时可能再次出错，同一个位置只报告一次
+        if (token.offset == lastErrorOffset)
+        {
+            return;
+        }
+
+        lastErrorOffset = token.offset;
+
+        if (diagnosticBuffer != nullptr)
+        {
+            diagnosticBuffer->push_back({Logger::LogLevel::ERROR, std::move(msg), token.offset, token.length});
+            return;
+        }
+
+        context->report(Logger::LogLevel::ERROR, std::move(msg), token.offset, token.length);
     }
 
-    inline void backToSnapshot()
+    // 报告一个错误并放弃当前的语句
+    [[noreturn]] inline void error(const Token &token, std::string msg)
     {
-        currentPos = snapshot;
+        reportError(token, std::move(msg));
+        throw ParseError();
     }
 
-    bool isTypeStart();
+    /**
+     * 出错后跳过 Token ，直到可以重新开始解析的位置
+     * 在代码块中停在 ';' 之后，或者 '}' 、 fn 、 struct 、 impl 、 let 之前
+     * 在全局范围内只停在 fn 、 struct 、 impl 、 let 之前，因为中间的 ';' 和 '}' 可能属于出错的函数体
+     * start 是出错的语句开始的位置，如果还没有前进过，至少跳过一个 Token ，避免在同一个位置反复出错
+     */
+    void synchronize(size_t start, bool insideBlock);
+
+    /**
+     * 进入一层嵌套，超过 CompileOptions::maxNestingDepth 时报告错误
+     * 递归的解析函数在调用前构造 NestingGuard ，返回或者出错回溯时恢复进入之前的深度
+     */
+    void enterNesting(const Token &token);
+
+    struct NestingGuard
+    {
+        Parser *parser;
+        size_t savedDepth;
+
+        explicit NestingGuard(Parser *parser) : parser(parser), savedDepth(parser->nestingDepth) {}
+
+        ~NestingGuard()
+        {
+            parser->nestingDepth = savedDepth;
+        }
+    };
+
+    // 延迟解析函数体之前，准备好 tokens 和 knownStructs
+    void prepareForBodies();
+
+    // 通过括号匹配跳过函数体，记录它在 TokenStream 中的范围
+    void skipFunctionBody(uint32_t &begin, uint32_t &end);
+
+    // 解析之前跳过的函数体，出错时返回 ErrorStmt
+    Stmt *parseSkippedBody(uint32_t begin, uint32_t offset);
+
+    /**
+     * 并行解析所有跳过的函数体
+     * 函数体按 Token 数量切分成连续的分块，每个任务用自己的 Parser 和内存池顺序解析一个分块
+     * 完成后按源代码顺序把内存池合并到 Context::astContext 中
+     */
+    void parseBodiesInParallel(size_t threadCount);
+
+    bool isPrimitiveType();
     bool isLiteral();
-    
-    int getPrecedence(TokenCode type);
-    void initLineInformation(std::unique_ptr<ASTNode> &node);
+
+    /**
+     * 在 Context::astContext 中创建一个 AST 节点，并记录它在源代码中的下标
+     * 不指定 offset 时使用当前 Token 的位置
+     */
+    template <typename T>
+    inline T *createNode(uint32_t offset)
+    {
+        T *node = getASTContext().create<T>();
+        node->offset = offset;
+        return node;
+    }
+
+    template <typename T>
+    inline T *createNode()
+    {
+        return createNode<T>(currentToken().offset);
+    }
+
+    template <typename T, size_t N>
+    inline ASTList<T> createList(const ASTListBuilder<T, N> &builder)
+    {
+        return getASTContext().createList(builder);
+    }
 
     /* 解析函数 */
-    std::vector<std::unique_ptr<Param>> parseParameterList();
-
-    std::unique_ptr<ASTNode> parseGlobalStatement();
-    // std::unique_ptr<ImportStmt> parseImptStatement();
-    std::unique_ptr<StructDef> parseStructDefinition();
-    std::unique_ptr<StructImpl> parseStructImplementation();
-    std::unique_ptr<FunctionDef> parseFunctionDefinition();
-    std::unique_ptr<GlobalVarDef> parseGlobalVariableDefinition();
-    // std::unique_ptr<ModulePath> parseModulePath();
-    std::unique_ptr<MemberVarDef> parseMemberVariableDefinition();
-    std::unique_ptr<Type> parseType();
-    std::unique_ptr<MemberFunctionDef> parseMemberFunctionDefinition();
-    std::unique_ptr<Param> parseParameter();
-    std::unique_ptr<CompoundStmt> parseCompoundStatement();
-    std::unique_ptr<Stmt> parseStatement();
-    std::unique_ptr<Expr> parseExpression();
-    std::unique_ptr<IfStmt> parseIfStmt();
-    std::unique_ptr<ReturnStmt> parseReturnStmt();
-    std::unique_ptr<DeclStmt> parseDeclarationStatement();
-    std::unique_ptr<ForStmt> parseForLoop();
-    std::unique_ptr<WhileStmt> parseWhileLoop();
-    std::unique_ptr<Expr> parseBinaryExpression(int minPrecedence);
-    std::unique_ptr<Expr> parsePrimary();
-    std::vector<std::unique_ptr<Expr>> parseArgumentList();
-    std::unique_ptr<ParenExpr> parseParenthesized();
-    std::unique_ptr<LiteralExpr> parseLiteral();
-    std::unique_ptr<CastExpr> parseCastExpression(std::unique_ptr<Type> type);
-    std::unique_ptr<StructInitExpr> parseStructInitialization(const std::string &typeName);
-    std::unique_ptr<Expr> parseFunctionCall(const std::string &name);
-    std::unique_ptr<Expr> parseMemberAccessChain(std::unique_ptr<Expr> left);
+    ASTList<Param *> parseParameterList();
+
+    // 解析一条语句，出错时返回 ErrorStmt
+    Stmt *parseStatementOrRecover();
+
+    ASTNode *parseGlobalStatement();
+    // ImportStmt *parseImptStatement();
+    StructDef *parseStructDefinition();
+    StructImpl *parseStructImplementation();
+    FunctionDef *parseFunctionDefinition();
+    GlobalVarDef *parseGlobalVariableDefinition();
+    // ModulePath *parseModulePath();
+    MemberVarDef *parseMemberVariableDefinition();
+    Type *parseType();
+    MemberFunctionDef *parseMemberFunctionDefinition();
+    Param *parseParameter();
+    CompoundStmt *parseCompoundStatement();
+    Stmt *parseStatement();
+    Expr *parseExpression();
+    IfStmt *parseIfStmt();
+    ReturnStmt *parseReturnStmt();
+    DeclStmt *parseDeclarationStatement();
+    ForStmt *parseForLoop();
+    WhileStmt *parseWhileLoop();
+
+    /**
+     * parseExpression 使用 Pratt 算法解析表达式，绑定强度在 OperatorTable.hpp 中预先算好
+     * 等待结合的前缀运算符、括号和二元运算符保存在显式的栈中，所以 ((((a)))) 和 ----a 这样的嵌套不会递归
+     * 只有函数调用参数、类型转换和结构体初始化中的表达式会递归调用 parseExpression
+     */
+    Expr *parsePostfix(Expr *left);
+    Expr *parsePrimary();
+    ASTList<Expr *> parseArgumentList();
+    LiteralExpr *parseLiteral();
+    CastExpr *parseCastExpression(Type *type);
+    StructInitExpr *parseStructInitialization(const Token &typeToken);
+    Expr *parseFunctionCall(const Token &nameToken);
 };
\ No newline at end of file
@@ -0,0 +1,273 @@
+#include "Core/CompilePipeline.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+// 运行到语义分析为止，返回所有诊断信息
+static std::vector<std::string> analyze(const std::string &code, size_t threads = 1)
+{
+    std::shared_ptr<Context> context = std::make_shared<Context>();
+    context->filePath = "test.lis";
+    context->options.analyzerThreads = threads;
+    context->setSource(code);
+
+    CompilePipeline compilePipeline{context};
+    compilePipeline.run();
+
+    std::vector<std::string> messages;
+    for (const Diagnostic &diagnostic : context->diagnostics.getDiagnostics())
+    {
+        messages.push_back(diagnostic.msg);
+    }
+    return messages;
+}
+
+static const std::string structSource = R"(
+struct Point
+{
+    pub x: i32,
+    pub y: i32,
+}
+
+impl Point
+{
+    fn sum(self) -> i32
+    {
+        ret self.x + self.y;
+    }
+}
+)";
+
+TEST(AnalyzerTest, AcceptsValidProgram)
+{
+    std::string code = structSource + R"(
+fn fib(n: i32) -> i32
+{
+    if (n == 0 || n == 1)
+    {
+        ret 1;
+    }
+
+    ret fib(n - 2) + fib(n - 1);
+}
+
+fn scale(p: Point, factor: i32 = 2) -> i32
+{
+    ret p.sum() * factor;
+}
+
+fn main()
+{
+    let mut p: Point = Point { x: 1, y: 2 };
+    let total = scale(p) + scale(p, 3);
+    p.x = fib(total);
+    let ratio: f64 = f64(p.x) * 0.5;
+    while (ratio > 1.0 && !(p.y == 0))
+    {
+        p.y = p.y - 1;
+    }
+    ret 0;
+}
+)";
+
+    EXPECT_EQ(analyze(code), std::vector<std::string>{});
+}
+
+TEST(AnalyzerTest, ReportsUndefinedNames)
+{
+    std::vector<std::string> messages = analyze(R"(
+fn main()
+{
+    let a: i32 = missing;
+    ret nowhere(a);
+}
+)");
+
+    EXPECT_EQ(messages, (std::vector<std::string>{
+                            "undefined identifier 'missing'",
+                            "undefined function 'nowhere'",
+                        }));
+}
+
+TEST(AnalyzerTest, ReportsTypeErrors)
+{
+    std::vector<std::string> messages = analyze(structSource + R"(
+fn main()
+{
+    let p: Point = Point { x: 1 };
+    let flag: bool = 1;
+    let n = p.z;
+    if (p.x)
+    {
+        ret p.sum(1);
+    }
+    ret p.x + flag;
+}
+)");
+
+    EXPECT_EQ(messages, (std::vector<std::string>{
+                            "missing member 'y' in initializer of 'Point'",
+                            "mismatched types for initial value of 'flag': expected 'bool', found '{integer}'",
+                            "type 'Point' has no member 'z'",
+                            "condition must be 'bool', found 'i32'",
+                            "'sum' expects 0 arguments but got 1",
+                            "mismatched types 'i32' and 'bool' for operator '+'",
+                        }));
+}
+
+TEST(AnalyzerTest, RejectsAssignmentToImmutable)
+{
+    std::vector<std::string> messages = analyze(structSource + R"(
+fn main()
+{
+    let p: Point = Point { x: 1, y: 2 };
+    let mut q: Point = p;
+    q.x = 3;
+    p.y = 4;
+    ret 0;
+}
+
+fn throughReference(a: &i32)
+{
+    let mut r: &i32 = a;
+    r = 5;
+}
+
+fn throughStructReference(a: &Point)
+{
+    let mut r: &Point = a;
+    r.x = 5;
+}
+)");
+
+    EXPECT_EQ(messages, (std::vector<std::string>{"cannot assign to immutable 'p'", "cannot assign to immutable 'r'", "cannot assign to immutable 'r'"}));
+}
+
+TEST(AnalyzerTest, RejectsMutableBorrowOfImmutable)
+{
+    std::vector<std::string> messages = analyze(R"(
+struct Counter
+{
+    pub count: i32,
+}
+
+impl Counter
+{
+    fn bump(self: &mut Counter)
+    {
+        self.count = self.count + 1;
+    }
+}
+
+fn bump(x: &mut i32)
+{
+    x = x + 1;
+}
+
+fn forward(y: &i32, z: &mut i32)
+{
+    bump(z);
+    bump(y);
+}
+
+fn main()
+{
+    let a: i32 = 1;
+    let mut b: i32 = 2;
+    let c: Counter = Counter { count: 0 };
+    let mut d: Counter = Counter { count: 0 };
+    bump(b);
+    bump(d.count);
+    d.bump();
+    bump(a);
+    bump(c.count);
+    c.bump();
+    let r: &mut i32 = a;
+    ret 0;
+}
+)");
+
+    EXPECT_EQ(messages, (std::vector<std::string>{
+                            "mismatched types for argument 'x': expected '&mut i32', found '&i32'",
+                            "cannot pass immutable 'a' as argument 'x'",
+                            "cannot pass immutable 'c' as argument 'x'",
+                            "cannot pass immutable 'c' as '&mut self' of method 'bump'",
+                            "cannot pass immutable 'a' as initial value of 'r'",
+                        }));
+}
+
+TEST(AnalyzerTest, LongOperatorChainsDoNotRecurse)
+{
+    // 左结合的运算符链在 AST 中是一条很深的左侧链
+    std::string code = "fn main()\n{\n    let a: i32 = 1;\n    let b: i32 = a";
+    for (int i = 0; i < 200000; i++)
+    {
+        code += " + a";
+    }
+    code += ";\n    ret b;\n}\n";
+
+    EXPECT_EQ(analyze(code), std::vector<std::string>{});
+}
+
+TEST(AnalyzerTest, ChecksMembersThroughStructLayouts)
+{
+    // 成员很多的结构体，成员通过布局中的哈希表查找
+    std::string code = "struct Wide\n{\n";
+    for (int i = 0; i < 64; i++)
+    {
+        code += "    pub field" + std::to_string(i) + ": " + (i % 2 == 0 ? "i32" : "f64") + ",\n";
+    }
+    code += R"(    pub field7: i32,
+}
+
+fn main()
+{
+    let mut wide: Wide = Wide { field0: 1, field1: 2.0, field63: 3.0 };
+    wide.field62 = wide.field0 + 1;
+    wide.field63 = wide.field62;
+    wide.field64 = 0;
+    ret 0;
+}
+)";
+
+    std::vector<std::string> messages = analyze(code);
+
+    ASSERT_GE(messages.size(), 4);
+    EXPECT_EQ(messages[0], "duplicate member 'field7' in struct 'Wide'");
+    EXPECT_EQ(messages[1], "missing member 'field2' in initializer of 'Wide'");
+    EXPECT_EQ(messages[messages.size() - 2], "mismatched types for assigned value: expected 'f64', found 'i32'");
+    EXPECT_EQ(messages.back(), "type 'Wide' has no member 'field64'");
+    // 重复的成员、 61 个没有初始化的成员和两个成员访问的错误
+    EXPECT_EQ(messages.size(), 1 + 61 + 2);
+}
+
+TEST(AnalyzerTest, ParallelCheckMatchesSequentialCheck)
+{
+    std::string code = structSource;
+    for (int i = 0; i < 300; i++)
+    {
+        const std::string index = std::to_string(i);
+        code += "fn func" + index + "(p: &mut Point, n: i32) -> i32\n{\n";
+        code += "    let local: i32 = p.sum() + n;\n";
+        code += "    p.x = local;\n";
+        // 每隔几个函数放一个错误，检查报告的顺序
+        if (i % 7 == 0)
+        {
+            code += "    let wrong: bool = local" + index + ";\n";
+        }
+        if (i % 11 == 0)
+        {
+            code += "    ret func" + std::to_string((i + 1) % 300) + "(p);\n";
+        }
+        code += "    ret local;\n}\n";
+    }
+
+    std::vector<std::string> sequential = analyze(code);
+    ASSERT_EQ(sequential.size(), 43 + 28);
+    EXPECT_EQ(sequential[0], "undefined identifier 'local0'");
+    EXPECT_EQ(sequential[1], "'func1' expects 2 arguments but got 1");
+
+    EXPECT_EQ(analyze(code, 8), sequential);
+    EXPECT_EQ(analyze(code, 3), sequential);
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "Core/CompilePipeline.hpp"
+#include "Parser/ASTPrinter.hpp"
+#include "Parser/FlatAST.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+
+// 扁平 AST 测试夹具
+class FlatASTTest : public ::testing::Test
+{
+protected:
+    const std::string source = "struct Point2D\n"
+                               "{\n"
+                               "    pub x: i32,\n"
+                               "    y: i32,\n"
+                               "}\n"
+                               "\n"
+                               "impl Point2D\n"
+                               "{\n"
+                               "    fn length(self: &Point2D) -> f64\n"
+                               "    {\n"
+                               "        ret f64(self.x * self.x + self.y * self.y);\n"
+                               "    }\n"
+                               "}\n"
+                               "\n"
+                               "fn main(count: i32)\n"
+                               "{\n"
+                               "    let mut point: Point2D = make(Pair { first: 1, second: count });\n"
+                               "    while (point.x < 10) { point.x = point.x + 1; }\n"
+                               "    if (point.length() != 2.0) { ret 1; } else { ret 0; }\n"
+                               "}\n";
+
+    std::shared_ptr<Context> parse(const std::string &code)
+    {
+        std::shared_ptr<Context> context = std::make_shared<Context>();
+        context->filePath = "test.lis";
+        context->options.buildFlatAST = true;
+        context->options.syntaxOnly = true;
+        context->setSource(code);
+
+        CompilePipeline compilePipeline{context};
+        compilePipeline.run();
+
+        return context;
+    }
+
+    // 两种表示的结构、种类和位置完全一致
+    void expectSameTree(const ASTNode *node, const FlatAST &flat, NodeIndex index)
+    {
+        ASSERT_NE(index, INVALID_NODE);
+        EXPECT_EQ(node->getKind(), flat.getKind(index));
+        EXPECT_EQ(node->offset, flat.getOffset(index));
+
+        std::vector<NodeIndex> flatChildren;
+        flat.forEachChild(index, [&](NodeIndex child) {
+            // 后序排列，子节点在父节点之前
+            EXPECT_LT(child, index);
+            flatChildren.push_back(child);
+        });
+
+        // ASTPrinter 把成员和参数的类型打印在同一行，不把它们当作子节点
+        std::vector<const ASTNode *> children = getChildren(node);
+        if (isa<MemberVarDef>(node) || isa<Param>(node) || isa<SelfParam>(node))
+        {
+            EXPECT_TRUE(children.empty());
+            return;
+        }
+
+        ASSERT_EQ(children.size(), flatChildren.size()) << getKindName(node->getKind());
+
+        for (size_t i = 0; i < children.size(); i++)
+        {
+            expectSameTree(children[i], flat, flatChildren[i]);
+        }
+    }
+};
+
+TEST_F(FlatASTTest, MatchesPointerTree)
+{
+    auto context = parse(source);
+    const FlatAST &flat = context->flatAST;
+
+    ASSERT_EQ(flat.getRoots().size(), context->program.globalStatements.size());
+
+    for (size_t i = 0; i < flat.getRoots().size(); i++)
+    {
+        expectSameTree(context->program.globalStatements[i], flat, flat.getRoots()[i]);
+    }
+
+    const Flat::FunctionDef &main = flat.get<Flat::FunctionDef>(flat.getRoots()[2]);
+    EXPECT_EQ(main.name.str(), "main");
+    EXPECT_EQ(main.returnType, INVALID_NODE);
+    ASSERT_EQ(main.params.count, 1);
+    EXPECT_EQ(flat.get<Flat::Param>(flat.getNodes(main.params)[0]).name.str(), "count");
+
+    const Flat::CompoundStmt &body = flat.get<Flat::CompoundStmt>(main.body);
+    const Flat::DeclStmt &decl = flat.get<Flat::DeclStmt>(flat.getNodes(body.statements)[0]);
+    const Flat::FunctionCall &make = flat.get<Flat::FunctionCall>(decl.initValue);
+    const Flat::StructInitExpr &init = flat.get<Flat::StructInitExpr>(flat.getNodes(make.arguments)[0]);
+    ASSERT_EQ(init.memberInits.count, 2);
+    EXPECT_EQ(flat.getMemberInits(init.memberInits)[1].name.str(), "second");
+}
+
+TEST_F(FlatASTTest, OutlivesPointerTree)
+{
+    auto context = parse(source);
+
+    FlatAST flat = context->flatAST;
+    const size_t size = flat.size();
+    context.reset();
+
+    EXPECT_EQ(flat.size(), size);
+    EXPECT_EQ(flat.get<Flat::StructDef>(flat.getRoots()[0]).name.str(), "Point2D");
+}
+
+TEST_F(FlatASTTest, SerializationRoundTrips)
+{
+    auto context = parse(source);
+
+    std::vector<std::byte> bytes = context->flatAST.serialize();
+    FlatAST restored = FlatAST::deserialize(bytes);
+
+    EXPECT_EQ(restored.size(), context->flatAST.size());
+    EXPECT_EQ(restored.serialize(), bytes);
+
+    for (size_t i = 0; i < restored.getRoots().size(); i++)
+    {
+        expectSameTree(context->program.globalStatements[i], restored, restored.getRoots()[i]);
+    }
+
+    bytes.resize(bytes.size() / 2);
+    EXPECT_THROW(FlatAST::deserialize(bytes), std::runtime_error);
+}
\ No newline at end of file
@@ -1,8 +1,12 @@
+#include "Core/StringInterner.hpp"
 #include "Lexer/Lexer.hpp"
 #include "Lexer/Token.hpp"
 
+#include <array>
 #include <gtest/gtest.h>
 #include <memory>
+#include <random>
+#include <unordered_set>
 
 // 词法分析器测试夹具
 class LexerTest : public ::testing::Test
@@ -20,7 +24,7 @@ protected:
 
     void runLexer(const std::string &source)
     {
-        context->fileValue = source;
+        context->setSource(source);
         lexer->run();
     }
 
@@ -34,12 +38,14 @@ protected:
         EXPECT_EQ(tok.code, code)
             << "Expected code: " << static_cast<int>(code)
             << ", got: " << static_cast<int>(tok.code);
-        EXPECT_EQ(tok.value, value)
-            << "Expected value: " << value << ", got: " << tok.value;
-        EXPECT_EQ(tok.line, line)
-            << "Expected line: " << line << ", got: " << tok.line;
-        EXPECT_EQ(tok.col, col)
-            << "Expected col: " << col << ", got: " << tok.col;
+        EXPECT_EQ(context->getTokenValue(tok), value)
+            << "Expected value: " << value << ", got: " << context->getTokenValue(tok);
+
+        SourceLocation location = context->getLocation(tok.offset);
+        EXPECT_EQ(location.line, line)
+            << "Expected line: " << line << ", got: " << location.line;
+        EXPECT_EQ(location.col, col)
+            << "Expected col: " << col << ", got: " << location.col;
     }
 };
 
@@ -247,4 +253,199 @@ TEST_F(LexerTest, HandlesComplexExpressions)
     expectToken(14, TokenCode::INT_LITERAL, "0", 1, 40);
     expectToken(15, TokenCode::SEMI, ";", 1, 41);
     expectToken(16, TokenCode::RBRACE, "}", 1, 43);
+}
+
+TEST_F(LexerTest, HandlesNumberBacktracking)
+{
+    runLexer("1.x 2.5.y 3e+4");
+
+    expectToken(0, TokenCode::INT_LITERAL, "1", 1, 1);
+    expectToken(1, TokenCode::DOT, ".", 1, 2);
+    expectToken(2, TokenCode::IDENTIFIER, "x", 1, 3);
+    expectToken(3, TokenCode::FLOAT_LITERAL, "2.5", 1, 5);
+    expectToken(4, TokenCode::DOT, ".", 1, 8);
+    expectToken(5, TokenCode::IDENTIFIER, "y", 1, 9);
+    expectToken(6, TokenCode::FLOAT_LITERAL, "3e+4", 1, 11);
+}
+
+TEST_F(LexerTest, HandlesLongCommentsAndStrings)
+{
+    std::string header = "/*" + std::string(100, ' ') + "\n *" + std::string(70, 'x') + "\n */\n";
+    runLexer(header + "let s = \"" + std::string(40, 'a') + "\\n\\\"b\";\n// " + std::string(50, '-') + "\nx");
+
+    expectToken(0, TokenCode::LET, "let", 4, 1);
+    expectToken(1, TokenCode::IDENTIFIER, "s", 4, 5);
+    expectToken(2, TokenCode::ASSIGN, "=", 4, 7);
+    expectToken(3, TokenCode::STRING_LITERAL, std::string(40, 'a') + "\n\"b", 4, 9);
+    expectToken(4, TokenCode::SEMI, ";", 4, 56);
+    expectToken(5, TokenCode::IDENTIFIER, "x", 6, 1);
+}
+
+TEST_F(LexerTest, StoresOnlyEscapedLiterals)
+{
+    runLexer("\"plain\" \"with\\tescape\" 'c' '\\n' \"keep\\q\"");
+
+    expectToken(0, TokenCode::STRING_LITERAL, "plain", 1, 1);
+    expectToken(1, TokenCode::STRING_LITERAL, "with\tescape", 1, 9);
+    expectToken(2, TokenCode::CHAR_LITERAL, "c", 1, 24);
+    expectToken(3, TokenCode::CHAR_LITERAL, "\n", 1, 28);
+    expectToken(4, TokenCode::STRING_LITERAL, "keep\\q", 1, 33);
+
+    // 只有值和源代码不同的两个字面量需要额外存储
+    EXPECT_EQ(context->literalPool.size(), 2);
+    EXPECT_EQ(context->tokenStream[0].literalIndex, Token::NO_LITERAL);
+    EXPECT_EQ(context->tokenStream[4].literalIndex, Token::NO_LITERAL);
+}
+
+TEST_F(LexerTest, ResolvesLocationsLazily)
+{
+    runLexer("a\n\nbc\r\n  d");
+
+    // 词法分析本身不需要行号，行首表只在第一次查询时建立
+    EXPECT_FALSE(context->lineTable.isBuilt());
+
+    expectToken(0, TokenCode::IDENTIFIER, "a", 1, 1);
+    expectToken(1, TokenCode::IDENTIFIER, "bc", 3, 1);
+    expectToken(2, TokenCode::IDENTIFIER, "d", 4, 3);
+
+    EXPECT_TRUE(context->lineTable.isBuilt());
+    EXPECT_EQ(context->lineTable.getLineCount(), 4);
+    EXPECT_EQ(context->getLocation(context->fileValue.size()).line, 4);
+}
+
+TEST_F(LexerTest, ClassifiesKeywordsByPerfectHash)
+{
+    for (size_t i = 0; i < keywords.size(); i++)
+    {
+        EXPECT_EQ(getKeywordPoistion(keywords[i]), i) << keywords[i];
+    }
+
+    // 和关键字长度、首尾字符都相同的标识符会落在同一个槽位，必须靠字符串比较排除
+    for (std::string_view name : {"iqpt", "sxxxxt", "fa", "lxt", "bxxl", "fxxxe", "i", "", "selfs", "_", "Fn"})
+    {
+        EXPECT_FALSE(getKeywordPoistion(name)) << name;
+    }
+}
+
+TEST_F(LexerTest, HandlesTokensAtEndOfInput)
+{
+    // 每个 Token 都紧挨着结尾的结束标记
+    for (const std::string source : {"abc", "12", "1.", "1e", "=", "/", "\"s\"", "'c'", "// comment", "/* comment"})
+    {
+        SetUp();
+        runLexer(source);
+
+        size_t length = 0;
+        for (const Token &token : context->tokenStream)
+        {
+            length = token.offset + token.length;
+        }
+
+        EXPECT_EQ(length, source.front() == '/' && source.size() > 1 ? 0 : source.size()) << source;
+    }
+
+    SetUp();
+    runLexer("1.");
+    expectToken(0, TokenCode::INT_LITERAL, "1", 1, 1);
+    expectToken(1, TokenCode::DOT, ".", 1, 2);
+}
+
+TEST_F(LexerTest, ParallelMatchesSequential)
+{
+    // 切分点很容易落在跨行的字符串和块注释里，也会落在行首的空白中
+    const std::string pieces[] = {
+        "fn main() -> i32 {\n",
+        "    let x: f64 = 1.5e-3 * (y + 42);\n",
+        "  \"multi\nline // not a comment\n\\\"string\\n\"\n",
+        "/* block\n comment \" with quote\n*/\n",
+        "// line comment /* not a block\n",
+        "    ret a.b::c => 'q' != '\\n';\n",
+        "\n\n      \n",
+        "\"/*\" x \"*/\" '\\''\n",
+    };
+
+    std::mt19937 random(42);
+    std::string source;
+    while (source.size() < 64 * 1024)
+    {
+        source += pieces[random() % std::size(pieces)];
+    }
+
+    runLexer(source);
+    const TokenStream expected = context->tokenStream;
+    const std::deque<std::string> expectedLiterals = context->literalPool;
+
+    for (size_t chunkSize : {64, 1000, 4096})
+    {
+        SetUp();
+        context->options.lexerThreads = 4;
+        context->options.lexerChunkSize = chunkSize;
+        runLexer(source);
+
+        const TokenStream &tokens = context->tokenStream;
+        ASSERT_EQ(tokens.size(), expected.size()) << chunkSize;
+        for (size_t i = 0; i < tokens.size(); i++)
+        {
+            EXPECT_EQ(tokens[i].code, expected[i].code) << i;
+            EXPECT_EQ(tokens[i].offset, expected[i].offset) << i;
+            EXPECT_EQ(tokens[i].length, expected[i].length) << i;
+            EXPECT_EQ(tokens[i].literalIndex, expected[i].literalIndex) << i;
+        }
+        EXPECT_EQ(context->literalPool, expectedLiterals) << chunkSize;
+    }
+}
+
+TEST_F(LexerTest, ParallelInternsNamesInSourceOrder)
+{
+    // 使用从没驻留过的名字，这样名字只会在下面的并行解析中第一次驻留
+    static int run = 0;
+    const std::string prefix = "parallel" + std::to_string(run++) + "_";
+
+    std::mt19937 random(7);
+    std::string source;
+    while (source.size() < 256 * 1024)
+    {
+        source += "let " + prefix + std::to_string(random() % 20000) + " = " + prefix + std::to_string(random() % 20000) + ";\n";
+    }
+
+    context->options.lexerThreads = 8;
+    context->options.lexerChunkSize = 1024;
+    runLexer(source);
+
+    // 顺序解析时，新名字在每个分片中按第一次出现的顺序得到连续的编号
+    std::unordered_set<uint32_t> seen;
+    std::array<uint32_t, 16> lastIndex{};
+    size_t names = 0;
+
+    for (const Token &token : context->tokenStream)
+    {
+        if (token.code != TokenCode::IDENTIFIER || !seen.insert(token.nameId).second)
+        {
+            continue;
+        }
+
+        uint32_t &last = lastIndex[token.nameId & 15];
+        if (last != 0)
+        {
+            ASSERT_EQ(token.nameId >> 4, last + 1) << NameId(token.nameId);
+        }
+        last = token.nameId >> 4;
+        names++;
+    }
+
+    EXPECT_GT(names, 5000);
+}
+
+TEST_F(LexerTest, InternsIdentifiers)
+{
+    runLexer("alpha beta alpha i32");
+
+    const TokenStream &tokens = context->tokenStream;
+    ASSERT_EQ(tokens.size(), 4);
+
+    EXPECT_EQ(tokens[0].nameId, tokens[2].nameId);
+    EXPECT_NE(tokens[0].nameId, tokens[1].nameId);
+    EXPECT_EQ(NameId(tokens[1].nameId).str(), "beta");
+    EXPECT_FALSE(tokens[0].hasLiteral());
+    EXPECT_EQ(context->getTokenValue(tokens[0]), "alpha");
 }
\ No newline at end of file
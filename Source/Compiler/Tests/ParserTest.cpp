@@ -0,0 +1,561 @@
+#include "Core/CompilePipeline.hpp"
+#include "Lexer/TokenCursor.hpp"
+#include "Parser/ASTPrinter.hpp"
+#include "Parser/OperatorTable.hpp"
+#include "Parser/Parser.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <regex>
+
+// 语法分析器测试夹具
+class ParserTest : public ::testing::Test
+{
+protected:
+    const std::string source = "struct Point2D\n"
+                               "{\n"
+                               "    pub x: i32,\n"
+                               "    y: i32,\n"
+                               "}\n"
+                               "\n"
+                               "impl Point2D\n"
+                               "{\n"
+                               "    fn distance(self: &mut Point2D, other: &mut Point2D) -> f64\n"
+                               "    {\n"
+                               "        ret math.sqrt(f64(self.x - other.x) * 2.5e-3, \"a\\\"b\\n\");\n"
+                               "    }\n"
+                               "}\n"
+                               "\n"
+                               "fn main()\n"
+                               "{\n"
+                               "    let mut point: Point2D = make(0, 0);\n"
+                               "    while (point.x < 10 && point.y >= 2 || true)\n"
+                               "    {\n"
+                               "        point.x = point.x + 1 * (2 - 3) / 4;\n"
+                               "    }\n"
+                               "    for (i in point) { io.println('x', point.distance(origin)); }\n"
+                               "    if (point.x != 2) { ret 1; } else { ret 0; }\n"
+                               "}\n";
+
+    std::shared_ptr<Context> parse(const std::string &code, CompileOptions options)
+    {
+        std::shared_ptr<Context> context = std::make_shared<Context>();
+        context->filePath = "test.lis";
+        context->options = options;
+        context->options.syntaxOnly = true;
+        context->setSource(code);
+
+        CompilePipeline compilePipeline{context};
+        compilePipeline.run();
+
+        return context;
+    }
+
+    // 输出 AST ，去掉每次运行都不同的节点地址
+    std::string dump(Context &context)
+    {
+        testing::internal::CaptureStdout();
+        printAST(context);
+        return std::regex_replace(testing::internal::GetCapturedStdout(), std::regex("0x[0-9a-f]+"), "");
+    }
+};
+
+TEST_F(ParserTest, StreamingMatchesMaterialized)
+{
+    CompileOptions streaming;
+    streaming.streamingLexer = true;
+
+    auto materializedContext = parse(source, {});
+    auto streamingContext = parse(source, streaming);
+
+    EXPECT_FALSE(materializedContext->tokenStream.empty());
+    EXPECT_TRUE(streamingContext->tokenStream.empty());
+    EXPECT_EQ(dump(*materializedContext), dump(*streamingContext));
+}
+
+TEST_F(ParserTest, StreamingHandlesLongFiles)
+{
+    // 远多于环形缓冲区大小的 Token
+    std::string code;
+    for (int i = 0; i < 200; i++)
+    {
+        code += "fn func" + std::to_string(i) + "(a: i32, b: i32) -> i32 { ret a * (b + " + std::to_string(i) + "); }\n";
+    }
+
+    CompileOptions streaming;
+    streaming.streamingLexer = true;
+
+    auto context = parse(code, streaming);
+
+    EXPECT_EQ(context->program.globalStatements.size(), 200);
+    EXPECT_EQ(dump(*parse(code, {})), dump(*context));
+}
+
+TEST_F(ParserTest, TokenCursorKeepsBoundedLookback)
+{
+    std::shared_ptr<Context> context = std::make_shared<Context>();
+    std::string code;
+    for (size_t i = 0; i < TokenCursor::RING_SIZE * 2; i++)
+    {
+        code += "x ";
+    }
+    context->setSource(code);
+
+    TokenCursor cursor(std::make_unique<Lexer>(context));
+
+    const size_t start = cursor.getPosition();
+    ASSERT_NE(cursor.peek(), nullptr);
+    cursor.advance();
+
+    // 回退到仍在缓冲区中的位置是允许的
+    cursor.rewind(start);
+    EXPECT_EQ(cursor.peek()->offset, 0);
+
+    for (size_t i = 0; i < TokenCursor::RING_SIZE + 1; i++)
+    {
+        ASSERT_NE(cursor.peek(), nullptr);
+        cursor.advance();
+    }
+
+    EXPECT_THROW(cursor.rewind(start), std::logic_error);
+    EXPECT_THROW(cursor.peek(TokenCursor::RING_SIZE), std::logic_error);
+}
+
+TEST_F(ParserTest, NodesAreAllocatedInASTContext)
+{
+    auto context = parse(source, {});
+
+    EXPECT_GT(context->astContext.getAllocatedBytes(), 0);
+
+    // 列表元素也在内存池中，并且保持解析的顺序
+    auto function = dyn_cast<FunctionDef>(context->program.globalStatements[2]);
+    ASSERT_NE(function, nullptr);
+
+    auto body = dyn_cast<CompoundStmt>(function->body);
+    ASSERT_NE(body, nullptr);
+    ASSERT_EQ(body->statements.size(), 4);
+    EXPECT_NE(dyn_cast<DeclStmt>(body->statements[0]), nullptr);
+    EXPECT_NE(dyn_cast<IfStmt>(body->statements[3]), nullptr);
+}
+
+TEST_F(ParserTest, KindTagsIdentifyNodes)
+{
+    auto context = parse(source, {});
+
+    const ASTNode *node = context->program.globalStatements[2];
+    EXPECT_EQ(node->getKind(), ASTKind::FunctionDef);
+    EXPECT_EQ(getKindName(node->getKind()), "FunctionDef");
+    EXPECT_TRUE(isa<FunctionDef>(node));
+    EXPECT_FALSE(isa<Stmt>(node));
+    EXPECT_EQ(dyn_cast<StructDef>(node), nullptr);
+
+    const Stmt *body = cast<FunctionDef>(node)->body;
+    EXPECT_TRUE(isa<Stmt>(body));
+    EXPECT_FALSE(isa<Expr>(body));
+
+    // 可以省略的子节点是空指针
+    auto declaration = cast<DeclStmt>(cast<CompoundStmt>(body)->statements[0]);
+    EXPECT_NE(declaration->type, nullptr);
+    EXPECT_TRUE(isa<Expr>(declaration->initValue));
+    EXPECT_EQ(cast<FunctionDef>(node)->returnType, nullptr);
+
+#ifdef __DEBUG__
+    EXPECT_THROW(cast<StructDef>(node), std::logic_error);
+#endif
+}
+
+TEST_F(ParserTest, LiteralsAreReadFromSource)
+{
+    auto context = parse("fn main()\n"
+                         "{\n"
+                         "    print(8675309, 9.75e2, 'q', false, \"x\\\"y\\n\", \"plain\");\n"
+                         "}\n",
+                         {});
+
+    auto body = cast<CompoundStmt>(cast<FunctionDef>(context->program.globalStatements[0])->body);
+    auto call = cast<FunctionCall>(cast<ExprStmt>(body->statements[0])->expression);
+    ASSERT_EQ(call->arguments.size(), 6);
+
+    const std::string_view expected[] = {"8675309", "9.75e2", "q", "false", "x\"y\n", "plain"};
+    for (size_t i = 0; i < std::size(expected); i++)
+    {
+        EXPECT_EQ(context->getLiteralValue(*cast<LiteralExpr>(call->arguments[i])), expected[i]) << i;
+    }
+
+    // 字面量不会进入全局的名字表
+    const size_t names = StringInterner::getInstance().size();
+    NameId::get("8675309");
+    EXPECT_EQ(StringInterner::getInstance().size(), names + 1);
+}
+
+// 把表达式按照运算顺序加上括号
+static std::string parenthesize(const Expr *expr)
+{
+    if (auto binary = dyn_cast<BinaryOp>(expr))
+    {
+        return "(" + parenthesize(binary->left) + " " + std::string(getBinaryOpSpelling(binary->op)) + " " + parenthesize(binary->right) + ")";
+    }
+
+    if (auto unary = dyn_cast<UnaryOp>(expr))
+    {
+        return "(" + std::string(getUnaryOpSpelling(unary->op)) + parenthesize(unary->operand) + ")";
+    }
+
+    if (auto access = dyn_cast<MemberAccess>(expr))
+    {
+        return parenthesize(access->object) + "." + std::string(access->memberName.str());
+    }
+
+    if (auto call = dyn_cast<MemberFunctionCall>(expr))
+    {
+        return parenthesize(call->object) + "." + std::string(call->methodName.str()) + "()";
+    }
+
+    if (auto paren = dyn_cast<ParenExpr>(expr))
+    {
+        return parenthesize(paren->expression);
+    }
+
+    if (auto castExpr = dyn_cast<CastExpr>(expr))
+    {
+        return std::string(castExpr->targetType->typeName.str()) + "(" + parenthesize(castExpr->expression) + ")";
+    }
+
+    if (auto init = dyn_cast<StructInitExpr>(expr))
+    {
+        return std::string(init->structType->typeName.str()) + "{}";
+    }
+
+    if (auto identifier = dyn_cast<IdentifierExpr>(expr))
+    {
+        return std::string(identifier->name.str());
+    }
+
+    return "?";
+}
+
+TEST_F(ParserTest, BinaryOperatorsFollowPrecedenceTable)
+{
+    auto context = parse("fn f() { ret a - b - c + d * e / g < h && i | j || k == l & m; }", {});
+
+    auto body = cast<CompoundStmt>(cast<FunctionDef>(context->program.globalStatements[0])->body);
+    auto returnStmt = cast<ReturnStmt>(body->statements[0]);
+
+    EXPECT_EQ(parenthesize(returnStmt->returnValue), "((((((a - b) - c) + ((d * e) / g)) < h) && (i | j)) || ((k == l) & m))");
+    EXPECT_EQ(getBinaryOperator(TokenCode::OR).kind, BinaryOpKind::LogicalOr);
+    EXPECT_FALSE(getBinaryOperator(TokenCode::DOT).isOperator());
+}
+
+TEST_F(ParserTest, PrefixAndPostfixOperatorsBindTighter)
+{
+    const std::string code = "struct P { x: i32 }\n"
+                             "fn f() {\n"
+                             "    ret -a * b;\n"
+                             "    ret !x.y || -c - d;\n"
+                             "    ret (a + b).m().n * -(c);\n"
+                             "    ret !!P(a).x == i32(b);\n"
+                             "    ret P { x: 1 }.x;\n"
+                             "}";
+
+    auto context = parse(code, {});
+    ASSERT_FALSE(context->diagnostics.hasErrors());
+
+    auto body = cast<CompoundStmt>(cast<FunctionDef>(context->program.globalStatements[1])->body);
+
+    std::vector<std::string> expressions;
+    for (auto statement : body->statements)
+    {
+        expressions.push_back(parenthesize(cast<ReturnStmt>(statement)->returnValue));
+    }
+
+    ASSERT_EQ(expressions.size(), 5);
+    EXPECT_EQ(expressions[0], "((-a) * b)");
+    EXPECT_EQ(expressions[1], "((!x.y) || ((-c) - d))");
+    EXPECT_EQ(expressions[2], "((a + b).m().n * (-c))");
+    EXPECT_EQ(expressions[3], "((!(!P(a).x)) == i32(b))");
+    EXPECT_EQ(expressions[4], "P{}.x");
+}
+
+TEST_F(ParserTest, RecoversAndReportsEveryError)
+{
+    const std::string code = "fn first()\n"
+                             "{\n"
+                             "    let a: i32 = ;\n"
+                             "    let b: Missing = 1;\n"
+                             "    a = (1 + ;\n"
+                             "    ret a;\n"
+                             "}\n"
+                             "fn (x: i32) { ret x; }\n"
+                             "fn unclosed() { let c: i32 = 1;\n"
+                             "struct Point { x: i32, }\n"
+                             "fn last() { ret 0; }\n";
+
+    auto context = parse(code, {});
+
+    std::vector<Diagnostic> diagnostics = context->diagnostics.getDiagnostics();
+    ASSERT_EQ(diagnostics.size(), 5);
+    EXPECT_EQ(context->diagnostics.getErrorCount(), 5);
+
+    std::vector<std::string> messages;
+    for (const Diagnostic &diagnostic : diagnostics)
+    {
+        messages.push_back(diagnostic.msg);
+    }
+
+    EXPECT_EQ(messages[0], "expected expression");
+    EXPECT_EQ(messages[1], "undefined type 'Missing'");
+    EXPECT_EQ(messages[2], "expected expression");
+    EXPECT_EQ(messages[3], "expect a function name");
+    EXPECT_EQ(messages[4], "expected '}' after compound statement");
+    EXPECT_EQ(context->getLocation(diagnostics[4].position).line, 10);
+
+    // 出错的语句变成 ErrorStmt ，其它语句正常解析
+    const auto &globals = context->program.globalStatements;
+    ASSERT_EQ(globals.size(), 5);
+    EXPECT_TRUE(isa<FunctionDef>(globals[0]));
+    EXPECT_TRUE(isa<ErrorStmt>(globals[1]));
+    EXPECT_TRUE(isa<ErrorStmt>(globals[2]));
+    EXPECT_TRUE(isa<StructDef>(globals[3]));
+    EXPECT_TRUE(isa<FunctionDef>(globals[4]));
+
+    auto body = cast<CompoundStmt>(cast<FunctionDef>(globals[0])->body);
+    ASSERT_EQ(body->statements.size(), 4);
+    EXPECT_TRUE(isa<ErrorStmt>(body->statements[0]));
+    EXPECT_TRUE(isa<DeclStmt>(body->statements[1]));
+    EXPECT_TRUE(isa<ErrorStmt>(body->statements[2]));
+    EXPECT_TRUE(isa<ReturnStmt>(body->statements[3]));
+}
+
+TEST_F(ParserTest, RecoveryAlwaysMakesProgress)
+{
+    CompileOptions streaming;
+    streaming.streamingLexer = true;
+
+    for (const CompileOptions &options : {CompileOptions{}, streaming})
+    {
+        auto context = parse("} ) ; fn f() { } } let fn g( { ret", options);
+
+        EXPECT_TRUE(context->diagnostics.hasErrors());
+        EXPECT_FALSE(context->program.globalStatements.empty());
+    }
+}
+
+TEST_F(ParserTest, DeeplyNestedExpressionsUseExplicitStack)
+{
+    const size_t depth = 100000;
+
+    std::string code = "fn f() { ret ";
+    for (size_t i = 0; i < depth; i++)
+    {
+        code += "(-";
+    }
+    code += "a";
+    code += std::string(depth, ')');
+    code += "; }";
+
+    // 括号和前缀运算符各算一层嵌套
+    CompileOptions options;
+    options.maxNestingDepth = depth * 2 + 2;
+
+    auto context = parse(code, options);
+    ASSERT_FALSE(context->diagnostics.hasErrors());
+
+    auto body = cast<CompoundStmt>(cast<FunctionDef>(context->program.globalStatements[0])->body);
+    const Expr *expr = cast<ReturnStmt>(body->statements[0])->returnValue;
+
+    size_t levels = 0;
+    while (auto paren = dyn_cast<ParenExpr>(expr))
+    {
+        expr = cast<UnaryOp>(paren->expression)->operand;
+        levels++;
+    }
+
+    EXPECT_EQ(levels, depth);
+    EXPECT_EQ(cast<IdentifierExpr>(expr)->name, NameId::get("a"));
+}
+
+TEST_F(ParserTest, NestingLimitReportsDiagnostic)
+{
+    const size_t depth = 100000;
+
+    // 每个括号单独一行，避免输出诊断信息时打印过长的源代码行
+    std::string blocks = "fn f() {\n";
+    std::string parens = "fn f() { ret\n";
+    for (size_t i = 0; i < depth; i++)
+    {
+        blocks += "{\n";
+        parens += "(\n";
+    }
+    blocks += "ret 0;\n";
+    parens += "a\n";
+    for (size_t i = 0; i < depth; i++)
+    {
+        blocks += "}\n";
+        parens += ")\n";
+    }
+    blocks += "}\nfn g() { ret 0; }\n";
+    parens += "; }\nfn g() { ret 0; }\n";
+
+    for (const std::string &code : {blocks, parens})
+    {
+        auto context = parse(code, {});
+
+        std::vector<Diagnostic> diagnostics = context->diagnostics.getDiagnostics();
+        ASSERT_FALSE(diagnostics.empty());
+        EXPECT_EQ(diagnostics[0].msg, "nesting too deep, the limit is 1024");
+
+        // 出错后继续解析之后的函数
+        const auto &globals = context->program.globalStatements;
+        ASSERT_FALSE(globals.empty());
+        auto last = dyn_cast<FunctionDef>(globals.back());
+        ASSERT_NE(last, nullptr);
+        EXPECT_EQ(last->name, NameId::get("g"));
+    }
+}
+
+TEST_F(ParserTest, LazyBodiesReachableFromMainMatchEagerParse)
+{
+    CompileOptions lazy;
+    lazy.lazyFunctionBodies = true;
+
+    // main 调用了 point.distance ，所以所有函数体都会被解析
+    auto eagerContext = parse(source, {});
+    auto lazyContext = parse(source, lazy);
+
+    EXPECT_EQ(dump(*lazyContext), dump(*eagerContext));
+}
+
+TEST_F(ParserTest, LazyBodiesReachableFromInitializersAndDefaults)
+{
+    // 只在全局变量的初始值和参数的默认值中调用的函数也要解析，其中的错误和立即解析时一样报告
+    const std::string code = "fn helper() -> i32 { let = 1; ret 2; }\n"
+                             "fn fallback() -> i32 { ret 3; }\n"
+                             "fn unused() -> i32 { ret 4; }\n"
+                             "let g: i32 = helper();\n"
+                             "fn scale(x: i32 = fallback()) -> i32 { ret x; }\n"
+                             "fn main() -> i32 { ret scale() + g; }\n";
+
+    CompileOptions lazy;
+    lazy.lazyFunctionBodies = true;
+
+    auto eagerContext = parse(code, {});
+    auto lazyContext = parse(code, lazy);
+
+    const auto &globals = lazyContext->program.globalStatements;
+    ASSERT_EQ(globals.size(), 6);
+    EXPECT_FALSE(cast<FunctionDef>(globals[0])->hasPendingBody());
+    EXPECT_FALSE(cast<FunctionDef>(globals[1])->hasPendingBody());
+    EXPECT_TRUE(cast<FunctionDef>(globals[2])->hasPendingBody());
+
+    EXPECT_EQ(lazyContext->diagnostics.getErrorCount(), 1);
+    EXPECT_EQ(eagerContext->diagnostics.getErrorCount(), 1);
+}
+
+TEST_F(ParserTest, UnreachableBodiesAreParsedOnDemand)
+{
+    const std::string code = "fn unused() { let = 1; }\n"
+                             "fn helper() -> i32 { ret 1; }\n"
+                             "fn main() { ret helper(); }\n";
+
+    CompileOptions lazy;
+    lazy.lazyFunctionBodies = true;
+
+    auto context = parse(code, lazy);
+    EXPECT_FALSE(context->diagnostics.hasErrors());
+
+    const auto &globals = context->program.globalStatements;
+    ASSERT_EQ(globals.size(), 3);
+
+    auto unused = cast<FunctionDef>(globals[0]);
+    EXPECT_TRUE(unused->hasPendingBody());
+    EXPECT_NE(cast<FunctionDef>(globals[1])->body, nullptr);
+    EXPECT_NE(cast<FunctionDef>(globals[2])->body, nullptr);
+
+    // 之后按需解析，函数体中的错误在这时报告
+    Parser parser(context);
+    parser.parseBody(unused);
+
+    EXPECT_FALSE(unused->hasPendingBody());
+    EXPECT_EQ(context->diagnostics.getErrorCount(), 1);
+    EXPECT_EQ(cast<CompoundStmt>(unused->body)->statements.size(), 1);
+}
+
+TEST_F(ParserTest, ParallelBodiesMatchSequentialParse)
+{
+    std::string code = source;
+    for (int i = 0; i < 200; i++)
+    {
+        const std::string name = "func" + std::to_string(i);
+        code += "fn " + name + "(a: i32, b: Point2D) -> i32\n"
+                "{\n"
+                "    let c: i32 = a * " + std::to_string(i) + " + b.x;\n"
+                "    while (c > 0) { c = c - 1; if (c == 3) { ret Point2D { x: c, y: a }.y; } }\n"
+                "    ret " + name + "(-c, b);\n"
+                "}\n";
+    }
+
+    CompileOptions parallel;
+    parallel.parserThreads = 4;
+
+    auto sequentialContext = parse(code, {});
+    auto parallelContext = parse(code, parallel);
+
+    EXPECT_FALSE(parallelContext->diagnostics.hasErrors());
+    EXPECT_EQ(dump(*parallelContext), dump(*sequentialContext));
+    EXPECT_EQ(parallelContext->astContext.getAllocatedBytes(), sequentialContext->astContext.getAllocatedBytes());
+}
+
+TEST_F(ParserTest, ParallelBodiesReportErrorsInSourceOrder)
+{
+    const std::string code = "fn first() { let a: i32 = ; }\n"
+                             "fn (x: i32) { ret x; }\n"
+                             "fn second() { a = (1 + ; }\n"
+                             "let = 1;\n"
+                             "fn third() { let b: Missing = 1; }\n";
+
+    CompileOptions parallel;
+    parallel.parserThreads = 4;
+
+    auto sequentialContext = parse(code, {});
+    auto parallelContext = parse(code, parallel);
+
+    std::vector<Diagnostic> expected = sequentialContext->diagnostics.getDiagnostics();
+    std::vector<Diagnostic> actual = parallelContext->diagnostics.getDiagnostics();
+
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); i++)
+    {
+        EXPECT_EQ(actual[i].msg, expected[i].msg);
+        EXPECT_EQ(actual[i].position, expected[i].position);
+    }
+}
+
+TEST(ASTContextTest, AllocationsAreAlignedAndReleasedTogether)
+{
+    ASTContext astContext;
+
+    for (size_t i = 0; i < 10000; i++)
+    {
+        astContext.allocate(1, 1);
+        void *aligned = astContext.allocate(24, 16);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 16, 0);
+    }
+
+    // 大于内存块四分之一的分配单独使用一块内存
+    auto *large = static_cast<char *>(astContext.allocate(1024 * 1024, 8));
+    large[1024 * 1024 - 1] = 1;
+
+    ASTListBuilder<int, 2> builder;
+    for (int i = 0; i < 5; i++)
+    {
+        builder.push_back(i);
+    }
+
+    ASTList<int> list = astContext.createList(builder);
+    ASSERT_EQ(list.size(), 5);
+    EXPECT_EQ(list[0], 0);
+    EXPECT_EQ(list[4], 4);
+
+    astContext.reset();
+    EXPECT_EQ(astContext.getAllocatedBytes(), 0);
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "Lexer/Scanner.hpp"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+// 扫描函数测试夹具，和逐字节的朴素实现对比结果
+class ScannerTest : public ::testing::Test
+{
+protected:
+    std::string randomSource(size_t length, unsigned seed)
+    {
+        // 字符集中包含所有扫描函数关心的字符，让它们在各种位置出现
+        const std::string alphabet = "  \t\n\r\v\fab*/\"\\x";
+        std::mt19937 random(seed);
+        std::string result;
+
+        for (size_t i = 0; i < length; i++)
+        {
+            result += alphabet[random() % alphabet.size()];
+        }
+
+        return result;
+    }
+};
+
+TEST_F(ScannerTest, ReportsImplementation)
+{
+    std::string name = Scanner::getImplementationName();
+    EXPECT_TRUE(name == "avx2" || name == "sse2" || name == "scalar") << name;
+}
+
+TEST_F(ScannerTest, HandlesEmptyRange)
+{
+    const char *text = "";
+
+    EXPECT_EQ(Scanner::findNonWhitespace(text, text), text);
+    EXPECT_EQ(Scanner::findByte(text, text, '\n'), text);
+    EXPECT_EQ(Scanner::findBlockCommentEnd(text, text), text);
+    EXPECT_EQ(Scanner::findStringSpecial(text, text), text);
+    EXPECT_EQ(Scanner::countNewlines(text, text), 0);
+}
+
+TEST_F(ScannerTest, MatchesScalarResults)
+{
+    for (unsigned seed = 0; seed < 64; seed++)
+    {
+        const std::string source = randomSource(seed * 7 + 1, seed);
+        const char *begin = source.data();
+        const char *end = begin + source.size();
+
+        // 每个起点都测一遍，覆盖 SIMD 主循环和尾部处理
+        for (const char *p = begin; p < end; p++)
+        {
+            const std::string_view rest(p, end - p);
+
+            size_t nonWhitespace = rest.find_first_not_of(" \t\n\v\f\r");
+            size_t newline = rest.find('\n');
+            size_t commentEnd = rest.find("*/");
+            size_t special = rest.find_first_of("\"\\");
+
+            EXPECT_EQ(Scanner::findNonWhitespace(p, end) - p, nonWhitespace == std::string_view::npos ? rest.size() : nonWhitespace);
+            EXPECT_EQ(Scanner::findByte(p, end, '\n') - p, newline == std::string_view::npos ? rest.size() : newline);
+            EXPECT_EQ(Scanner::findBlockCommentEnd(p, end) - p, commentEnd == std::string_view::npos ? rest.size() : commentEnd);
+            EXPECT_EQ(Scanner::findStringSpecial(p, end) - p, special == std::string_view::npos ? rest.size() : special);
+            EXPECT_EQ(Scanner::countNewlines(p, end), std::count(rest.begin(), rest.end(), '\n'));
+        }
+    }
+}
\ No newline at end of file
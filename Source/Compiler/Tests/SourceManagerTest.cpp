@@ -0,0 +1,83 @@
+#include "Core/SourceManager.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+
+// 源文件管理器测试夹具
+class SourceManagerTest : public ::testing::Test
+{
+protected:
+    SourceManager sourceManager;
+    std::string path = testing::TempDir() + "SourceManagerTest.lis";
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+    }
+
+    void writeFile(const std::string &code)
+    {
+        std::ofstream file{path, std::ios::binary};
+        file << code;
+    }
+
+    // 文件内容正确，并且结尾之后有 '\0'
+    void expectLoaded(const std::string &code)
+    {
+        writeFile(code);
+
+        std::optional<uint16_t> id = sourceManager.loadFile(path);
+        ASSERT_TRUE(id);
+
+        const SourceFile &file = sourceManager.getFile(*id);
+        EXPECT_EQ(file.path, path);
+        EXPECT_EQ(file.content, code);
+
+        for (size_t i = 0; i < SourceFile::PADDING_SIZE; i++)
+        {
+            EXPECT_EQ(file.content.data()[code.size() + i], '\0');
+        }
+    }
+};
+
+TEST_F(SourceManagerTest, LoadsFiles)
+{
+    expectLoaded("fn main() { ret 0; }\n");
+}
+
+TEST_F(SourceManagerTest, LoadsEmptyFiles)
+{
+    expectLoaded("");
+}
+
+TEST_F(SourceManagerTest, PadsFilesEndingAtPageBoundary)
+{
+    // 常见的页大小的整数倍，映射之后没有空间放下结尾标记，需要退回到读取文件
+    expectLoaded(std::string(4096, 'a'));
+    expectLoaded(std::string(65536, 'b'));
+
+    // 页末尾的空间不足以放下全部填充时也一样
+    expectLoaded(std::string(4096 - SourceFile::PADDING_SIZE / 2, 'c'));
+}
+
+TEST_F(SourceManagerTest, ReportsMissingFiles)
+{
+    EXPECT_FALSE(sourceManager.loadFile(path + ".missing"));
+    EXPECT_EQ(sourceManager.getFileCount(), 0);
+}
+
+TEST_F(SourceManagerTest, CopiesBuffers)
+{
+    std::string code = "let x = 1;";
+    uint16_t first = sourceManager.addBuffer("a.lis", code);
+    uint16_t second = sourceManager.addBuffer("b.lis", "let y = 2;");
+    code.clear();
+
+    EXPECT_EQ(first, 0);
+    EXPECT_EQ(second, 1);
+    EXPECT_EQ(sourceManager.getFile(first).content, "let x = 1;");
+    EXPECT_EQ(sourceManager.getFile(second).path, "b.lis");
+    EXPECT_EQ(sourceManager.getFile(second).content.data()[10], '\0');
+}
\ No newline at end of file
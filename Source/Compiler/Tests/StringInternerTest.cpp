@@ -0,0 +1,76 @@
+#include "Core/StringInterner.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(StringInternerTest, InternsEqualStringsOnce)
+{
+    NameId first = NameId::get("interner_point");
+    NameId second = NameId::get(std::string("interner_") + "point");
+
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, NameId::get("interner_points"));
+    EXPECT_EQ(first.str(), "interner_point");
+}
+
+TEST(StringInternerTest, EmptyStringIsDefault)
+{
+    EXPECT_EQ(NameId::get(""), NameId());
+    EXPECT_TRUE(NameId().empty());
+    EXPECT_EQ(NameId().str(), "");
+}
+
+TEST(StringInternerTest, KeepsStringsStable)
+{
+    // 足够多的名字会触发哈希表扩容和新的内存块
+    std::vector<NameId> names;
+    for (int i = 0; i < 20000; i++)
+    {
+        names.push_back(NameId::get("stable_" + std::to_string(i)));
+    }
+
+    const std::string longName(100000, 'x');
+    NameId longId = NameId::get(longName);
+
+    for (int i = 0; i < 20000; i++)
+    {
+        EXPECT_EQ(names[i].str(), "stable_" + std::to_string(i));
+        EXPECT_EQ(names[i], NameId::get("stable_" + std::to_string(i)));
+    }
+
+    EXPECT_EQ(longId.str(), longName);
+}
+
+TEST(StringInternerTest, InternsConcurrently)
+{
+    constexpr int THREAD_COUNT = 4;
+    constexpr int NAME_COUNT = 5000;
+
+    std::vector<std::vector<NameId>> results(THREAD_COUNT);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < THREAD_COUNT; t++)
+    {
+        threads.emplace_back([t, &results] {
+            for (int i = 0; i < NAME_COUNT; i++)
+            {
+                results[t].push_back(NameId::get("concurrent_" + std::to_string(i)));
+            }
+        });
+    }
+
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    // 所有线程得到的编号必须相同
+    for (int t = 1; t < THREAD_COUNT; t++)
+    {
+        EXPECT_EQ(results[t], results[0]);
+    }
+
+    EXPECT_EQ(results[0][42].str(), "concurrent_42");
+}
\ No newline at end of file
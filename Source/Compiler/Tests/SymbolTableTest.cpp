@@ -0,0 +1,108 @@
+#include "Analyzer/SymbolTable.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+static SymbolTable::Symbol makeSymbol(NameId name, SymbolTable::SymbolKind kind = SymbolTable::SymbolKind::VARIABLE)
+{
+    SymbolTable::Symbol symbol;
+    symbol.kind = kind;
+    symbol.name = name;
+    return symbol;
+}
+
+TEST(SymbolTableTest, InnerScopesShadowOuterScopes)
+{
+    SymbolTable table;
+    NameId x = NameId::get("symbol_x");
+    NameId y = NameId::get("symbol_y");
+
+    ASSERT_TRUE(table.addSymbol(makeSymbol(x, SymbolTable::SymbolKind::FUNCTION)));
+    EXPECT_TRUE(table.lookup(x)->isGlobal);
+
+    table.enterScope();
+    ASSERT_TRUE(table.addSymbol(makeSymbol(x, SymbolTable::SymbolKind::PARAMETER)));
+    ASSERT_TRUE(table.addSymbol(makeSymbol(y)));
+    EXPECT_EQ(table.lookup(x)->kind, SymbolTable::SymbolKind::PARAMETER);
+    EXPECT_FALSE(table.lookup(x)->isGlobal);
+
+    table.enterScope();
+    EXPECT_EQ(table.lookupCurrentScope(x), nullptr);
+    ASSERT_TRUE(table.addSymbol(makeSymbol(x)));
+    EXPECT_EQ(table.lookup(x)->kind, SymbolTable::SymbolKind::VARIABLE);
+    EXPECT_EQ(table.getScopeDepth(), 3);
+
+    table.exitScope();
+    EXPECT_EQ(table.lookup(x)->kind, SymbolTable::SymbolKind::PARAMETER);
+    EXPECT_NE(table.lookup(y), nullptr);
+
+    table.exitScope();
+    EXPECT_EQ(table.lookup(x)->kind, SymbolTable::SymbolKind::FUNCTION);
+    EXPECT_EQ(table.lookup(y), nullptr);
+    EXPECT_EQ(table.lookup(NameId::get("symbol_missing")), nullptr);
+}
+
+TEST(SymbolTableTest, RejectsRedefinitionInSameScope)
+{
+    SymbolTable table;
+    NameId name = NameId::get("symbol_twice");
+
+    table.enterScope();
+    EXPECT_TRUE(table.addSymbol(makeSymbol(name)));
+    EXPECT_FALSE(table.addSymbol(makeSymbol(name)));
+    EXPECT_FALSE(table.addSymbol(makeSymbol(NameId())));
+    EXPECT_NE(table.lookupCurrentScope(name), nullptr);
+
+    table.exitScope();
+    EXPECT_THROW(table.exitScope(), std::logic_error);
+}
+
+TEST(SymbolTableTest, GrowsAndUndoesManyScopes)
+{
+    SymbolTable table;
+
+    // 足够多的名字会触发哈希表扩容
+    std::vector<NameId> names;
+    for (int i = 0; i < 5000; i++)
+    {
+        names.push_back(NameId::get("symbol_" + std::to_string(i)));
+    }
+
+    for (int i = 0; i < 5000; i++)
+    {
+        table.enterScope();
+        ASSERT_TRUE(table.addSymbol(makeSymbol(names[i])));
+
+        // 同时遮蔽一个外层作用域中的名字
+        if (i != 0)
+        {
+            ASSERT_TRUE(table.addSymbol(makeSymbol(names[i / 2])));
+        }
+    }
+
+    for (int i = 4999; i >= 0; i--)
+    {
+        ASSERT_NE(table.lookupCurrentScope(names[i]), nullptr);
+        table.exitScope();
+    }
+
+    for (NameId name : names)
+    {
+        EXPECT_EQ(table.lookup(name), nullptr);
+    }
+    EXPECT_EQ(table.getScopeDepth(), 1);
+}
+
+TEST(SymbolTableTest, StructsAreSeparateFromValues)
+{
+    SymbolTable table;
+    StructDef point;
+    point.name = NameId::get("symbol_Point");
+
+    EXPECT_TRUE(table.addStruct(&point));
+    EXPECT_FALSE(table.addStruct(&point));
+    EXPECT_EQ(table.getStruct(point.name), &point);
+    EXPECT_EQ(table.lookup(point.name), nullptr);
+    EXPECT_TRUE(table.addSymbol(makeSymbol(point.name)));
+}
\ No newline at end of file
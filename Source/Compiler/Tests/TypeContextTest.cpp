@@ -0,0 +1,116 @@
+#include "Analyzer/Types.hpp"
+#include "Parser/AST.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(TypeContextTest, PrimitivesAreUniqued)
+{
+    TypeContext types;
+
+    const SemanticType *i32 = types.getPrimitive(NameId::get("i32"));
+    ASSERT_NE(i32, nullptr);
+    EXPECT_EQ(i32, types.getBuiltin(SemanticType::Kind::I32));
+    EXPECT_EQ(types.getPrimitive(NameId::get("bool")), types.getBoolType());
+    EXPECT_EQ(types.getPrimitive(NameId::get("Point")), nullptr);
+
+    EXPECT_TRUE(i32->isInteger());
+    EXPECT_FALSE(i32->isFloat());
+    EXPECT_EQ(types.concretize(types.getBuiltin(SemanticType::Kind::FloatLiteral)), types.getPrimitive(NameId::get("f64")));
+    EXPECT_EQ(i32->toString(), "i32");
+}
+
+TEST(TypeContextTest, StructsAndReferencesAreUniqued)
+{
+    TypeContext types;
+
+    StructDef point;
+    point.name = NameId::get("TypePoint");
+
+    const SemanticType *pointType = types.createStructType(&point);
+    ASSERT_NE(pointType, nullptr);
+    EXPECT_EQ(types.createStructType(&point), nullptr);
+    EXPECT_EQ(types.getStructType(point.name), pointType);
+    EXPECT_EQ(pointType->getStructDef(), &point);
+
+    const SemanticType *ref = types.getReferenceType(pointType, false);
+    const SemanticType *mutRef = types.getReferenceType(pointType, true);
+    EXPECT_NE(ref, mutRef);
+    EXPECT_EQ(types.getReferenceType(pointType, false), ref);
+    EXPECT_EQ(types.getReferenceType(ref, true), ref);
+    EXPECT_EQ(mutRef->withoutReference(), pointType);
+    EXPECT_TRUE(mutRef->isMutReference());
+    EXPECT_EQ(mutRef->toString(), "&mut TypePoint");
+}
+
+TEST(TypeContextTest, FunctionTypesAreUniqued)
+{
+    TypeContext types;
+
+    const SemanticType *i32 = types.getBuiltin(SemanticType::Kind::I32);
+    const SemanticType *f64 = types.getBuiltin(SemanticType::Kind::F64);
+
+    std::vector<const SemanticType *> params = {i32, f64};
+    const SemanticType *function = types.getFunctionType(i32, params);
+
+    std::vector<const SemanticType *> sameParams = {i32, f64};
+    EXPECT_EQ(types.getFunctionType(i32, sameParams), function);
+
+    std::vector<const SemanticType *> swappedParams = {f64, i32};
+    EXPECT_NE(types.getFunctionType(i32, swappedParams), function);
+    EXPECT_NE(types.getFunctionType(f64, params), function);
+    EXPECT_NE(types.getFunctionType(i32, {}), function);
+
+    EXPECT_EQ(function->getReturnType(), i32);
+    ASSERT_EQ(function->getParamTypes().size(), 2);
+    EXPECT_EQ(function->getParamTypes()[1], f64);
+    EXPECT_EQ(function->toString(), "fn(i32, f64) -> i32");
+}
+
+TEST(TypeContextTest, StructLayoutsFollowCAlignment)
+{
+    TypeContext types;
+
+    const SemanticType *i8 = types.getBuiltin(SemanticType::Kind::I8);
+    const SemanticType *i32 = types.getBuiltin(SemanticType::Kind::I32);
+    const SemanticType *f64 = types.getBuiltin(SemanticType::Kind::F64);
+
+    MemberVarDef a, b, c;
+    a.name = NameId::get("layout_a");
+    b.name = NameId::get("layout_b");
+    c.name = NameId::get("layout_c");
+    MemberVarDef *innerMembers[] = {&a, &b};
+    MemberVarDef *outerMembers[] = {&a, &b, &c};
+
+    StructDef inner;
+    inner.name = NameId::get("LayoutInner");
+    inner.members = ASTList<MemberVarDef *>(innerMembers, 2);
+
+    StructDef outer;
+    outer.name = NameId::get("LayoutOuter");
+    outer.members = ASTList<MemberVarDef *>(outerMembers, 3);
+
+    const SemanticType *innerType = types.createStructType(&inner);
+    const SemanticType *outerType = types.createStructType(&outer);
+    EXPECT_EQ(innerType->getLayout(), nullptr);
+
+    // { i8, i32 } 的大小是 8 ，对齐是 4
+    std::vector<const SemanticType *> innerTypes = {i8, i32};
+    const StructLayout *innerLayout = types.createStructLayout(innerType, innerTypes);
+    EXPECT_EQ(innerType->getLayout(), innerLayout);
+    EXPECT_EQ(innerLayout->getMember(1).offset, 4);
+    EXPECT_EQ(innerLayout->getSize(), 8);
+    EXPECT_EQ(innerLayout->getAlignment(), 4);
+
+    // { i8, LayoutInner, f64 } 的成员偏移是 0 、 4 、 16
+    std::vector<const SemanticType *> outerTypes = {i8, innerType, f64};
+    const StructLayout *outerLayout = types.createStructLayout(outerType, outerTypes);
+    EXPECT_EQ(outerLayout->getMember(1).offset, 4);
+    EXPECT_EQ(outerLayout->getMember(2).offset, 16);
+    EXPECT_EQ(outerLayout->getSize(), 24);
+    EXPECT_EQ(outerLayout->getAlignment(), 8);
+
+    EXPECT_EQ(outerLayout->getMemberIndex(c.name), 2);
+    EXPECT_EQ(outerLayout->getMember(outerLayout->getMemberIndex(b.name)).type, innerType);
+    EXPECT_EQ(outerLayout->getMemberIndex(NameId::get("layout_missing")), StructLayout::NO_MEMBER);
+}
\ No newline at end of file
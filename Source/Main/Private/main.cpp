@@ -45,7 +45,13 @@ int main(int argc, const char **argv)
     CompilePipeline compilePipeline{context};
     compilePipeline.run();
 
-    printAST(context->program);
+    // 所有错误都已经输出
+    if (context->diagnostics.hasErrors())
+    {
+        return 1;
+    }
+
+    printAST(*context);
 
     return 0;
 }
\ No newline at end of file
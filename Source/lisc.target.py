@@ -15,7 +15,7 @@ class liscTarget(BuildSystem.TargetBase):
         self.TargetType = BuildSystem.TargetTypeEnum.Program
         self.bBuildAllmodules = True
         self.ModulesSubFolder = [""]
-        self.ArgumentsAdded = ["-std=c++20", "-Wno-deprecated-declarations", "-Wno-deprecated-enum-enum-conversion", "-finput-charset=UTF-8", "-fexec-charset=UTF-8", "-DUNICODE"]
+        self.ArgumentsAdded = ["-std=c++20", "-Wno-deprecated-declarations", "-Wno-deprecated-enum-enum-conversion", "-finput-charset=UTF-8", "-fexec-charset=UTF-8", "-DUNICODE", "-pthread"]
 
         match BuildSystem.BuildContext.BuildType:
             case BuildSystem.BuildTypeEnum.Release: